@@ -0,0 +1,659 @@
+/**
+ *
+ * Descripcion: Implementation of the functions that sort many arrays at once
+ *
+ * Fichero: batch.c
+ * Autor: Ignacio Sánchez and Fabio Desio
+ * Version: 1.0
+ * Fecha: 18-10-2026
+ *
+ */
+
+#include <stdlib.h>
+#include <limits.h>
+#include <assert.h>
+#include "batch.h"
+#include "pool.h"
+#include "simd.h"
+#include "networks.h"
+#include "ob.h"
+
+/* Lanes of an AVX2 register of ints */
+#define LANES 8
+
+typedef struct batch {
+  int **arrays;     /* list of arrays, or NULL for a strided block */
+  int *block;       /* strided block */
+  int stride;       /* distance between the arrays of the block */
+  int n_arrays;     /* number of arrays */
+  int N;            /* number of elements of each array */
+  pfunc_sort method;
+  int *obs;         /* ob of each array, can be NULL */
+  int n_cmp;        /* comparators of the sorting network */
+  const int *ci;    /* first wire of each comparator */
+  const int *cj;    /* second wire of each comparator */
+  long ob;          /* total ob */
+  PCOUNTERS counters; /* counters of the calling thread, can be NULL */
+  int status;
+} BATCH, *PBATCH;
+
+typedef struct segments {
+  int *tabla;             /* array with all the segments */
+  const long *offsets;    /* segment s is tabla[offsets[s]..offsets[s+1]-1] */
+  long *obs;              /* ob of each segment, can be NULL */
+  pfunc_sort method;
+  pfunc_sort64 wide;      /* 64-bit version of method, can be NULL */
+  long (*merge)(int *, long, long, long); /* merge of the slices */
+  int *order;             /* segments by size, the huge ones at the end */
+  int **ptrs;             /* first element of each segment of order */
+  int n_small;            /* segments of order that are not huge */
+  int n_huge;             /* huge segments */
+  long *task_first;       /* first position in order of each small task */
+  int n_small_tasks;      /* tasks of the small segments */
+  int slices;             /* slices of each huge segment */
+  int width;              /* slices of each half in the current merge round */
+  int n_pairs;            /* merges of each huge segment in the round */
+  long ob;                /* total ob */
+  PCOUNTERS counters;     /* counters of the calling thread, can be NULL */
+  int status;
+} SEGMENTS, *PSEGMENTS;
+
+/**
+ * Adds the counters of a task to the counters of the calling thread. 
+ * Several tasks can do it at the same time
+ * @param dest counters of the calling thread, can be NULL
+ * @param src counters of the task
+ */
+static void add_counters(PCOUNTERS dest, PCOUNTERS src)
+{
+  if (dest == NULL)
+    return;
+
+  __sync_fetch_and_add(&dest->comparisons, src->comparisons);
+  __sync_fetch_and_add(&dest->swaps, src->swaps);
+  __sync_fetch_and_add(&dest->moves, src->moves);
+  __sync_fetch_and_add(&dest->allocations, src->allocations);
+  __sync_fetch_and_add(&dest->bytes, src->bytes);
+}
+
+/**
+ * Returns the i-th array of the batch
+ * @param pb pointer to the batch
+ * @param i index of the array
+ * @return Pointer to the first element of the array
+ */
+static int *batch_array(PBATCH pb, int i)
+{
+  if (pb->arrays != NULL)
+    return pb->arrays[i];
+
+  return pb->block + (long)i * pb->stride;
+}
+
+/**
+ * Applies the sorting network of the batch to one array
+ * @param pb pointer to the batch
+ * @param a pointer to the array
+ */
+static void network_scalar(PBATCH pb, int *a)
+{
+  int c, x, y;
+
+  for (c = 0; c < pb->n_cmp; c++)
+  {
+    x = a[pb->ci[c]];
+    y = a[pb->cj[c]];
+    a[pb->ci[c]] = x < y ? x : y;
+    a[pb->cj[c]] = x < y ? y : x;
+  }
+}
+
+#if SIMD_AVX2
+/**
+ * Applies the sorting network of the batch to LANES arrays at a time:
+ * element j of array l goes to lane l of register j, so each comparator
+ * is one min and one max over the LANES arrays
+ * @param pb pointer to the batch
+ * @param first index of the first of the LANES arrays
+ */
+TARGET_AVX2 static void network_lanes(PBATCH pb, int first)
+{
+  __m256i v[BATCH_SIMD_MAX], lo;
+  int t[BATCH_SIMD_MAX][LANES];
+  int *a[LANES];
+  int j, l, c;
+
+  for (l = 0; l < LANES; l++)
+    a[l] = batch_array(pb, first + l);
+
+  /* Trasponemos: un registro por posición */
+  for (j = 0; j < pb->N; j++)
+  {
+    for (l = 0; l < LANES; l++)
+      t[j][l] = a[l][j];
+    v[j] = _mm256_loadu_si256((__m256i *)t[j]);
+  }
+
+  for (c = 0; c < pb->n_cmp; c++)
+  {
+    lo = _mm256_min_epi32(v[pb->ci[c]], v[pb->cj[c]]);
+    v[pb->cj[c]] = _mm256_max_epi32(v[pb->ci[c]], v[pb->cj[c]]);
+    v[pb->ci[c]] = lo;
+  }
+
+  for (j = 0; j < pb->N; j++)
+  {
+    _mm256_storeu_si256((__m256i *)t[j], v[j]);
+    for (l = 0; l < LANES; l++)
+      a[l][j] = t[j][l];
+  }
+}
+#endif
+
+/**
+ * Task of the pool: sorts the arrays of chunk t of the batch
+ * @param arg pointer to the batch
+ * @param t index of the chunk
+ */
+static void batch_task(void *arg, int t)
+{
+  PBATCH pb = (PBATCH)arg;
+  int i, first, last, ob;
+  long suma_obs = 0;
+  COUNTERS cuentas;
+  PCOUNTERS previas;
+
+  first = t * BATCH_CHUNK;
+  last = first + BATCH_CHUNK;
+  if (last > pb->n_arrays)
+    last = pb->n_arrays;
+
+  i = first;
+
+  /* Cada tarea cuenta aparte y suma al final en los contadores del
+   * hilo que llamó a sort_batch */
+  reset_counters(&cuentas);
+  previas = set_counters(&cuentas);
+
+  if (pb->n_cmp > 0)
+  {
+#if SIMD_AVX2
+    if (CPU_HAS_AVX2())
+    {
+      for (; i + LANES <= last; i += LANES)
+        network_lanes(pb, i);
+    }
+#endif
+    for (; i < last; i++)
+      network_scalar(pb, batch_array(pb, i));
+
+    suma_obs = (long)pb->n_cmp * (last - first);
+    cuentas.comparisons += suma_obs;
+    cuentas.moves += 2 * suma_obs;
+    cuentas.bytes += 2 * suma_obs * (long)sizeof(int);
+    if (pb->obs != NULL)
+    {
+      for (i = first; i < last; i++)
+        pb->obs[i] = pb->n_cmp;
+    }
+  }
+  else
+  {
+    for (; i < last; i++)
+    {
+      ob = pb->method(batch_array(pb, i), 0, pb->N - 1);
+      if (ob == ERR)
+      {
+        set_counters(previas);
+        pb->status = ERR;
+        return;
+      }
+      if (pb->obs != NULL)
+        pb->obs[i] = ob;
+      suma_obs += ob;
+    }
+  }
+
+  set_counters(previas);
+
+  __sync_fetch_and_add(&pb->ob, suma_obs);
+  add_counters(pb->counters, &cuentas);
+}
+
+/**
+ * Sorts all the arrays of the batch, spreading the chunks over the
+ * shared thread pool when the batch is big enough
+ * @param pb pointer to the batch
+ * @return Total number of basic operations
+ *         ERR in case of error
+ */
+static long run_batch(PBATCH pb)
+{
+  PPOOL ppool = NULL;
+  int n_tasks, t;
+
+  pb->ob = 0;
+  pb->counters = get_counters();
+  pb->status = OK;
+  pb->n_cmp = pb->N <= BATCH_SIMD_MAX ? sortnet_comparators(pb->N, &pb->ci, &pb->cj) : 0;
+
+  n_tasks = (pb->n_arrays + BATCH_CHUNK - 1) / BATCH_CHUNK;
+
+  if ((double)pb->n_arrays * pb->N >= BATCH_PARALLEL_MIN)
+    ppool = default_pool();
+
+  if (ppool != NULL)
+  {
+    if (pool_run(ppool, n_tasks, batch_task, pb) == ERR)
+      return ERR;
+  }
+  else
+  {
+    for (t = 0; t < n_tasks; t++)
+      batch_task(pb, t);
+  }
+
+  if (pb->status == ERR)
+    return ERR;
+
+  return pb->ob;
+}
+
+/**
+ * Sorts n_arrays arrays of N elements each. Arrays of BATCH_SIMD_MAX 
+ * elements or less are sorted with a sorting network across arrays, the
+ * rest with method. Big batches are split among the threads of the pool
+ * @param arrays array of pointers to the arrays to sort
+ * @param n_arrays number of arrays
+ * @param N number of elements of each array
+ * @param method sorting function for the arrays bigger than BATCH_SIMD_MAX
+ * @param obs array where the ob of each array is stored, can be NULL
+ * @return Total number of basic operations performed
+ *         ERR in case of error
+ */
+long sort_batch(int **arrays, int n_arrays, int N, pfunc_sort method, int *obs)
+{
+  BATCH b;
+
+  if (arrays == NULL || n_arrays < 0 || N < 1 || method == NULL)
+    return ERR;
+
+  b.arrays = arrays;
+  b.block = NULL;
+  b.stride = 0;
+  b.n_arrays = n_arrays;
+  b.N = N;
+  b.method = method;
+  b.obs = obs;
+
+  return run_batch(&b);
+}
+
+/**
+ * Same as sort_batch for n_arrays arrays stored in one block, the i-th 
+ * one starting at block + i * stride
+ * @param block pointer to the block of arrays
+ * @param n_arrays number of arrays
+ * @param N number of elements of each array
+ * @param stride distance between the beginning of two consecutive arrays
+ * @param method sorting function for the arrays bigger than BATCH_SIMD_MAX
+ * @param obs array where the ob of each array is stored, can be NULL
+ * @return Total number of basic operations performed
+ *         ERR in case of error
+ */
+long sort_strided(int *block, int n_arrays, int N, int stride, pfunc_sort method, int *obs)
+{
+  BATCH b;
+
+  if (block == NULL || n_arrays < 0 || N < 1 || stride < N || method == NULL)
+    return ERR;
+
+  b.arrays = NULL;
+  b.block = block;
+  b.stride = stride;
+  b.n_arrays = n_arrays;
+  b.N = N;
+  b.method = method;
+  b.obs = obs;
+
+  return run_batch(&b);
+}
+
+/**
+ * Returns the number of elements of segment s
+ * @param ps pointer to the segments
+ * @param s index of the segment
+ * @return Size of the segment
+ */
+static long segment_size(PSEGMENTS ps, int s)
+{
+  return ps->offsets[s + 1] - ps->offsets[s];
+}
+
+/**
+ * Returns the first position of slice k of the huge segment s, or the
+ * end of the segment when k is the number of slices
+ * @param ps pointer to the segments
+ * @param s index of the segment
+ * @param k index of the slice
+ * @return Position in tabla
+ */
+static long slice_bound(PSEGMENTS ps, int s, int k)
+{
+  return ps->offsets[s] + segment_size(ps, s) * k / ps->slices;
+}
+
+/**
+ * Sorts tabla[ip..iu] with the method of the segments
+ * @param ps pointer to the segments
+ * @param ip first element
+ * @param iu last element
+ * @return Number of basic operations
+ *         ERR in case of error
+ */
+static long sort_range(PSEGMENTS ps, long ip, long iu)
+{
+  if (ps->wide != NULL)
+    return ps->wide(ps->tabla, ip, iu);
+
+  /* Sin versión de 64 bits el segmento cabe en un int (sort_segments) */
+  return ps->method(ps->tabla + ip, 0, (int)(iu - ip));
+}
+
+/**
+ * Sorts the small segments order[first..last-1]. Runs of segments of the
+ * same size up to BATCH_SIMD_MAX go through the sorting network LANES at
+ * a time, the rest up to SORTNET_MAX through their network one by one and
+ * the bigger ones with the method
+ * @param ps pointer to the segments
+ * @param first first position in order
+ * @param last position after the last one
+ * @param pcounters counters of the task
+ * @return Number of basic operations
+ *         ERR in case of error
+ */
+static long small_segments(PSEGMENTS ps, long first, long last, PCOUNTERS pcounters)
+{
+  BATCH b;
+  long i, j, k, n, ob, suma_obs = 0;
+
+  b.arrays = ps->ptrs;
+  b.block = NULL;
+
+  for (i = first; i < last; i = j)
+  {
+    n = segment_size(ps, ps->order[i]);
+
+    if (n <= BATCH_SIMD_MAX)
+    {
+      /* Racha de segmentos del mismo tamaño, ya agrupados por tamaño */
+      for (j = i + 1; j < last && segment_size(ps, ps->order[j]) == n; j++)
+        ;
+
+      b.N = (int)n;
+      b.n_cmp = sortnet_comparators(b.N, &b.ci, &b.cj);
+      k = i;
+#if SIMD_AVX2
+      if (CPU_HAS_AVX2())
+      {
+        for (; k + LANES <= j; k += LANES)
+          network_lanes(&b, (int)k);
+      }
+#endif
+      for (; k < j; k++)
+        network_scalar(&b, ps->ptrs[k]);
+
+      ob = (long)b.n_cmp * (j - i);
+      pcounters->comparisons += ob;
+      pcounters->moves += 2 * ob;
+      pcounters->bytes += 2 * ob * (long)sizeof(int);
+      suma_obs += ob;
+      if (ps->obs != NULL)
+      {
+        for (k = i; k < j; k++)
+          ps->obs[ps->order[k]] = b.n_cmp;
+      }
+      continue;
+    }
+
+    j = i + 1;
+    if (n <= SORTNET_MAX)
+    {
+      ob = sorting_network(ps->ptrs[i], 0, (int)n - 1);
+      pcounters->comparisons += ob;
+      pcounters->moves += 2 * ob;
+      pcounters->bytes += 2 * ob * (long)sizeof(int);
+    }
+    else
+    {
+      ob = sort_range(ps, ps->offsets[ps->order[i]], ps->offsets[ps->order[i] + 1] - 1);
+      if (ob == ERR)
+        return ERR;
+    }
+
+    if (ps->obs != NULL)
+      ps->obs[ps->order[i]] = ob;
+    suma_obs += ob;
+  }
+
+  return suma_obs;
+}
+
+/**
+ * Task of the pool for the first phase of sort_segments: the first 
+ * n_small_tasks tasks sort groups of small segments, the rest sort one
+ * slice of a huge segment each
+ * @param arg pointer to the segments
+ * @param t index of the task
+ */
+static void segments_task(void *arg, int t)
+{
+  PSEGMENTS ps = (PSEGMENTS)arg;
+  COUNTERS cuentas;
+  PCOUNTERS previas;
+  long ob;
+  int s, k;
+
+  reset_counters(&cuentas);
+  previas = set_counters(&cuentas);
+
+  if (t < ps->n_small_tasks)
+  {
+    ob = small_segments(ps, ps->task_first[t], ps->task_first[t + 1], &cuentas);
+  }
+  else
+  {
+    t -= ps->n_small_tasks;
+    s = ps->order[ps->n_small + t / ps->slices];
+    k = t % ps->slices;
+    ob = sort_range(ps, slice_bound(ps, s, k), slice_bound(ps, s, k + 1) - 1);
+    if (ob != ERR && ps->obs != NULL)
+      __sync_fetch_and_add(&ps->obs[s], ob);
+  }
+
+  set_counters(previas);
+
+  if (ob == ERR)
+  {
+    ps->status = ERR;
+    return;
+  }
+
+  __sync_fetch_and_add(&ps->ob, ob);
+  add_counters(ps->counters, &cuentas);
+}
+
+/**
+ * Task of the pool for one merge round of the huge segments: merges the
+ * sorted runs of width slices starting at slices k and k + width
+ * @param arg pointer to the segments
+ * @param t index of the task
+ */
+static void merge_task(void *arg, int t)
+{
+  PSEGMENTS ps = (PSEGMENTS)arg;
+  COUNTERS cuentas;
+  PCOUNTERS previas;
+  long ob;
+  int s, k, end;
+
+  s = ps->order[ps->n_small + t / ps->n_pairs];
+  k = (t % ps->n_pairs) * 2 * ps->width;
+  end = k + 2 * ps->width < ps->slices ? k + 2 * ps->width : ps->slices;
+
+  reset_counters(&cuentas);
+  previas = set_counters(&cuentas);
+  ob = ps->merge(ps->tabla, slice_bound(ps, s, k), slice_bound(ps, s, end) - 1,
+                 slice_bound(ps, s, k + ps->width) - 1);
+  set_counters(previas);
+
+  if (ps->obs != NULL)
+    __sync_fetch_and_add(&ps->obs[s], ob);
+  __sync_fetch_and_add(&ps->ob, ob);
+  add_counters(ps->counters, &cuentas);
+}
+
+/**
+ * Runs n_tasks tasks on the pool, or in the calling thread if it is NULL
+ * @param ppool pointer to the pool, can be NULL
+ * @param n_tasks number of tasks
+ * @param task function executed for each task
+ * @param arg argument shared by all the tasks
+ * @return OK
+ *         ERR in case of error
+ */
+static short run_on_pool(PPOOL ppool, int n_tasks, pfunc_task task, void *arg)
+{
+  int t;
+
+  if (ppool != NULL)
+    return pool_run(ppool, n_tasks, task, arg);
+
+  for (t = 0; t < n_tasks; t++)
+    task(arg, t);
+
+  return OK;
+}
+
+/**
+ * Sorts each of the n_segments segments of tabla, segment s being 
+ * tabla[offsets[s]..offsets[s+1]-1]. Segments are grouped by size: those
+ * of up to SORTNET_MAX elements are sorted with their sorting network 
+ * (the ones of the same size up to BATCH_SIMD_MAX several at a time), 
+ * those of less than SEGMENT_HUGE with method, and the huge ones are 
+ * split in one slice per thread of the pool, sorted with method and 
+ * merged back. All the work is spread over the shared thread pool
+ * @param tabla array with the segments
+ * @param offsets n_segments + 1 non decreasing positions of tabla
+ * @param n_segments number of segments
+ * @param method sorting function for the segments bigger than SORTNET_MAX
+ * @param obs array where the ob of each segment is stored, can be NULL
+ * @return Total number of basic operations performed
+ *         ERR in case of error
+ */
+long sort_segments(int *tabla, const long *offsets, int n_segments, pfunc_sort method, long *obs)
+{
+  SEGMENTS sg;
+  PPOOL ppool = NULL;
+  long counts[SORTNET_MAX + 3];
+  long n, elems;
+  int s, i, key, n_tasks;
+
+  if (tabla == NULL || offsets == NULL || n_segments < 0 || method == NULL || offsets[0] < 0)
+    return ERR;
+
+  sg.wide = wide_sort(method);
+
+  /* Agrupamos por tamaño: redes por tamaño exacto, medianos y enormes */
+  for (key = 0; key < SORTNET_MAX + 3; key++)
+    counts[key] = 0;
+
+  for (s = 0; s < n_segments; s++)
+  {
+    n = offsets[s + 1] - offsets[s];
+    if (n < 0 || (sg.wide == NULL && n > INT_MAX))
+      return ERR;
+    if (obs != NULL)
+      obs[s] = 0;
+    if (n >= 2)
+      counts[n <= SORTNET_MAX ? n : n < SEGMENT_HUGE ? SORTNET_MAX + 1 : SORTNET_MAX + 2]++;
+  }
+
+  for (key = 1; key < SORTNET_MAX + 3; key++)
+    counts[key] += counts[key - 1];
+
+  sg.tabla = tabla;
+  sg.offsets = offsets;
+  sg.obs = obs;
+  sg.method = method;
+  sg.n_small = (int)counts[SORTNET_MAX + 1];
+  sg.n_huge = (int)(counts[SORTNET_MAX + 2] - counts[SORTNET_MAX + 1]);
+  sg.ob = 0;
+  sg.counters = get_counters();
+  sg.status = OK;
+
+  /* Mezclamos sin contar solo si method es una variante sin contar */
+  sg.merge = sg.wide != NULL && uncounted_sort64(sg.wide) == sg.wide ? merge64_nc : merge64;
+
+  sg.order = (int *)malloc(((size_t)counts[SORTNET_MAX + 2] + 1) * sizeof(sg.order[0]));
+  sg.ptrs = (int **)malloc(((size_t)counts[SORTNET_MAX + 2] + 1) * sizeof(sg.ptrs[0]));
+  sg.task_first = (long *)malloc(((size_t)sg.n_small + 1) * sizeof(sg.task_first[0]));
+  if (sg.order == NULL || sg.ptrs == NULL || sg.task_first == NULL)
+  {
+    free(sg.order);
+    free(sg.ptrs);
+    free(sg.task_first);
+    return ERR;
+  }
+
+  for (s = n_segments - 1; s >= 0; s--)
+  {
+    n = offsets[s + 1] - offsets[s];
+    if (n < 2)
+      continue;
+    key = n <= SORTNET_MAX ? (int)n : n < SEGMENT_HUGE ? SORTNET_MAX + 1 : SORTNET_MAX + 2;
+    i = (int)--counts[key];
+    sg.order[i] = s;
+    sg.ptrs[i] = tabla + offsets[s];
+  }
+
+  /* Tareas de los segmentos pequeños de unos SEGMENT_TASK_ELEMS elementos */
+  sg.n_small_tasks = 0;
+  for (i = 0, elems = 0; i < sg.n_small; i++)
+  {
+    if (elems == 0)
+      sg.task_first[sg.n_small_tasks++] = i;
+    elems += segment_size(&sg, sg.order[i]);
+    if (elems >= SEGMENT_TASK_ELEMS)
+      elems = 0;
+  }
+  sg.task_first[sg.n_small_tasks] = sg.n_small;
+
+  if (n_segments > 0 && offsets[n_segments] - offsets[0] >= BATCH_PARALLEL_MIN)
+    ppool = default_pool();
+
+  sg.slices = ppool != NULL ? pool_size(ppool) : 1;
+  if (sg.slices < 1 || (double)sg.n_huge * sg.slices + sg.n_small_tasks > INT_MAX)
+    sg.slices = 1;
+  n_tasks = sg.n_small_tasks + sg.n_huge * sg.slices;
+
+  if (run_on_pool(ppool, n_tasks, segments_task, &sg) == ERR)
+    sg.status = ERR;
+
+  /* Mezcla por rondas de los trozos de los segmentos enormes */
+  for (sg.width = 1; sg.status == OK && sg.n_huge > 0 && sg.width < sg.slices; sg.width *= 2)
+  {
+    sg.n_pairs = (sg.slices - sg.width + 2 * sg.width - 1) / (2 * sg.width);
+    if (run_on_pool(ppool, sg.n_huge * sg.n_pairs, merge_task, &sg) == ERR)
+      sg.status = ERR;
+  }
+
+  free(sg.order);
+  free(sg.ptrs);
+  free(sg.task_first);
+
+  if (sg.status == ERR)
+    return ERR;
+
+  return sg.ob;
+}
@@ -0,0 +1,42 @@
+/**
+ *
+ * Descripcion: Header file for the functions that sort many arrays at once
+ *
+ * Fichero: batch.h
+ * Autor: Ignacio Sánchez and Fabio Desio
+ * Version: 1.0
+ * Fecha: 18-10-2026
+ *
+ */
+
+#ifndef BATCH_H
+#define BATCH_H
+
+#include "sorting.h"
+
+/* constants */
+
+#ifndef ERR
+  #define ERR -1
+  #define OK (!(ERR))
+#endif
+
+/* arrays of this size or smaller are sorted with the sorting network of
+ * networks.h, 8 arrays at a time in the lanes of an AVX2 register */
+#define BATCH_SIMD_MAX 16
+/* number of arrays of each task of the pool */
+#define BATCH_CHUNK 256
+/* minimum number of elements of the batch to use the thread pool */
+#define BATCH_PARALLEL_MIN (1 << 15)
+/* sort_segments: segments of this size or bigger are split among all the
+ * threads of the pool and merged back, smaller ones are grouped in tasks
+ * of about SEGMENT_TASK_ELEMS elements */
+#define SEGMENT_HUGE (1L << 18)
+#define SEGMENT_TASK_ELEMS (1L << 15)
+
+/* Functions */
+long sort_batch(int **arrays, int n_arrays, int N, pfunc_sort method, int *obs);
+long sort_strided(int *block, int n_arrays, int N, int stride, pfunc_sort method, int *obs);
+long sort_segments(int *tabla, const long *offsets, int n_segments, pfunc_sort method, long *obs);
+
+#endif
@@ -0,0 +1,103 @@
+/***********************************************************/
+/* Program: exercise10                 Date:               */
+/* Authors: Ignacio Sánchez and Fabio Desio                */
+/*                                                         */
+/* Programa that writes in a file                          */
+/* the average times of mergesort with the scalar          */
+/* or the AVX2 merge                                       */
+/*                                                         */
+/* Input: Command Line                                     */
+/* -num_min: lowest number of table elements               */
+/* -num_max: highest number of table elements              */
+/* -incr: increment\n                                      */
+/* -numP: number of permutations to average                */
+/* -outputFile: Output file name                           */
+/* -mergePath: scalar or avx2                              */
+/* Output: 0 in case of error                              */
+/* -1 otherwise                                            */
+/***********************************************************/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include "sorting.h"
+#include "times.h"
+
+int main(int argc, char **argv)
+{
+  int i, num_min, num_max, incr, n_perms;
+  char nombre[256], path[256];
+  short ret;
+
+  srand(time(NULL));
+
+  if (argc != 13)
+  {
+    fprintf(stderr, "Error in input parameters:\n\n");
+    fprintf(stderr, "%s -num_min <int> -num_max <int> -incr <int>\n", argv[0]);
+    fprintf(stderr, "\t\t -numP <int> -outputFile <string> -mergePath <scalar|avx2>\n");
+    fprintf(stderr, "Donde:\n");
+    fprintf(stderr, "-num_min: lowest number of table elements\n");
+    fprintf(stderr, "-num_max: highest number of table elements\n");
+    fprintf(stderr, "-incr: increment\n");
+    fprintf(stderr, "-numP: number of permutations to average\n");
+    fprintf(stderr, "-outputFile: Output file name\n");
+    fprintf(stderr, "-mergePath: merge used by mergesort, scalar or avx2\n");
+    exit(-1);
+  }
+
+  printf("Practice number 1, section 10\n");
+  printf("Done by: your names\n");
+  printf("Group: Your group\n");
+
+  /* check command line */
+  for (i = 1; i < argc; i++)
+  {
+    if (strcmp(argv[i], "-num_min") == 0)
+    {
+      num_min = atoi(argv[++i]);
+    }
+    else if (strcmp(argv[i], "-num_max") == 0)
+    {
+      num_max = atoi(argv[++i]);
+    }
+    else if (strcmp(argv[i], "-incr") == 0)
+    {
+      incr = atoi(argv[++i]);
+    }
+    else if (strcmp(argv[i], "-numP") == 0)
+    {
+      n_perms = atoi(argv[++i]);
+    }
+    else if (strcmp(argv[i], "-outputFile") == 0)
+    {
+      strcpy(nombre, argv[++i]);
+    }
+    else if (strcmp(argv[i], "-mergePath") == 0)
+    {
+      strcpy(path, argv[++i]);
+    }
+    else
+    {
+      fprintf(stderr, "Wrong paramenter %s\n", argv[i]);
+    }
+  }
+
+  if (set_merge_path(strcmp(path, "avx2") == 0 ? MERGE_AVX2 : MERGE_SCALAR) == ERR)
+  {
+    printf("The CPU does not support the AVX2 merge\n");
+    exit(-1);
+  }
+
+  /* compute times */
+  ret = generate_sorting_times(mergesort, nombre, num_min, num_max, incr, n_perms);
+  if (ret == ERR)
+  { /* ERR_TIME should be a negative number */
+    printf("Error in function generate_sorting_times\n");
+    exit(-1);
+  }
+  printf("Correct output \n");
+
+  return 0;
+}
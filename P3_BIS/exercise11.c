@@ -0,0 +1,112 @@
+/***********************************************************/
+/* Program: exercise11                 Date:               */
+/* Authors: Ignacio Sánchez and Fabio Desio                */
+/*                                                         */
+/* Programa that writes in a file                          */
+/* the average times of mergesort copying back the big     */
+/* merges with streaming stores or through the cache       */
+/*                                                         */
+/* Input: Command Line                                     */
+/* -num_min: lowest number of table elements               */
+/* -num_max: highest number of table elements              */
+/* -incr: increment\n                                      */
+/* -numP: number of permutations to average                */
+/* -outputFile: Output file name                           */
+/* -stream: auto, off or a threshold in bytes             */
+/* Output: 0 in case of error                              */
+/* -1 otherwise                                            */
+/***********************************************************/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include "sorting.h"
+#include "times.h"
+
+int main(int argc, char **argv)
+{
+  int i, num_min, num_max, incr, n_perms;
+  char nombre[256], stream[256];
+  long threshold;
+  short ret;
+
+  srand(time(NULL));
+
+  if (argc != 13)
+  {
+    fprintf(stderr, "Error in input parameters:\n\n");
+    fprintf(stderr, "%s -num_min <int> -num_max <int> -incr <int>\n", argv[0]);
+    fprintf(stderr, "\t\t -numP <int> -outputFile <string> -stream <auto|off|bytes>\n");
+    fprintf(stderr, "Donde:\n");
+    fprintf(stderr, "-num_min: lowest number of table elements\n");
+    fprintf(stderr, "-num_max: highest number of table elements\n");
+    fprintf(stderr, "-incr: increment\n");
+    fprintf(stderr, "-numP: number of permutations to average\n");
+    fprintf(stderr, "-outputFile: Output file name\n");
+    fprintf(stderr, "-stream: streaming copy-back of the merges bigger than the\n");
+    fprintf(stderr, "\t last level cache (auto), never (off) or bigger than <bytes>\n");
+    exit(-1);
+  }
+
+  printf("Practice number 1, section 11\n");
+  printf("Done by: your names\n");
+  printf("Group: Your group\n");
+
+  /* check command line */
+  for (i = 1; i < argc; i++)
+  {
+    if (strcmp(argv[i], "-num_min") == 0)
+    {
+      num_min = atoi(argv[++i]);
+    }
+    else if (strcmp(argv[i], "-num_max") == 0)
+    {
+      num_max = atoi(argv[++i]);
+    }
+    else if (strcmp(argv[i], "-incr") == 0)
+    {
+      incr = atoi(argv[++i]);
+    }
+    else if (strcmp(argv[i], "-numP") == 0)
+    {
+      n_perms = atoi(argv[++i]);
+    }
+    else if (strcmp(argv[i], "-outputFile") == 0)
+    {
+      strcpy(nombre, argv[++i]);
+    }
+    else if (strcmp(argv[i], "-stream") == 0)
+    {
+      strcpy(stream, argv[++i]);
+    }
+    else
+    {
+      fprintf(stderr, "Wrong paramenter %s\n", argv[i]);
+    }
+  }
+
+  if (strcmp(stream, "auto") == 0)
+    threshold = STREAM_AUTO;
+  else if (strcmp(stream, "off") == 0)
+    threshold = STREAM_OFF;
+  else
+    threshold = atol(stream);
+
+  if (set_stream_threshold(threshold) == ERR)
+  {
+    printf("Wrong threshold or the CPU has no streaming stores\n");
+    exit(-1);
+  }
+
+  /* compute times */
+  ret = generate_sorting_times(mergesort, nombre, num_min, num_max, incr, n_perms);
+  if (ret == ERR)
+  { /* ERR_TIME should be a negative number */
+    printf("Error in function generate_sorting_times\n");
+    exit(-1);
+  }
+  printf("Correct output \n");
+
+  return 0;
+}
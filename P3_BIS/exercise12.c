@@ -0,0 +1,128 @@
+/***********************************************************/
+/* Program: exercise12                 Date:               */
+/* Authors: Ignacio Sánchez and Fabio Desio                */
+/*                                                         */
+/* Programa that writes in a file                          */
+/* the average times of quicksort, introsort or pdqsort    */
+/* on permutations with a given shape                      */
+/*                                                         */
+/* Input: Command Line                                     */
+/* -num_min: lowest number of table elements               */
+/* -num_max: highest number of table elements              */
+/* -incr: increment\n                                      */
+/* -numP: number of permutations to average                */
+/* -outputFile: Output file name                           */
+/* -method: quicksort, introsort or pdqsort               */
+/* -shape: random, sorted, reversed, organ, prefix or few  */
+/* Output: 0 in case of error                              */
+/* -1 otherwise                                            */
+/***********************************************************/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include "sorting.h"
+#include "times.h"
+#include "permutations.h"
+
+int main(int argc, char **argv)
+{
+  int i, num_min, num_max, incr, n_perms;
+  char nombre[256], method[256], shape[256];
+  pfunc_sort metodo;
+  int forma;
+  short ret;
+
+  srand(time(NULL));
+
+  if (argc != 15)
+  {
+    fprintf(stderr, "Error in input parameters:\n\n");
+    fprintf(stderr, "%s -num_min <int> -num_max <int> -incr <int>\n", argv[0]);
+    fprintf(stderr, "\t\t -numP <int> -outputFile <string> -method <string> -shape <string>\n");
+    fprintf(stderr, "Donde:\n");
+    fprintf(stderr, "-num_min: lowest number of table elements\n");
+    fprintf(stderr, "-num_max: highest number of table elements\n");
+    fprintf(stderr, "-incr: increment\n");
+    fprintf(stderr, "-numP: number of permutations to average\n");
+    fprintf(stderr, "-outputFile: Output file name\n");
+    fprintf(stderr, "-method: quicksort, introsort or pdqsort\n");
+    fprintf(stderr, "-shape: random, sorted, reversed, organ, prefix or few\n");
+    exit(-1);
+  }
+
+  printf("Practice number 1, section 12\n");
+  printf("Done by: your names\n");
+  printf("Group: Your group\n");
+
+  /* check command line */
+  for (i = 1; i < argc; i++)
+  {
+    if (strcmp(argv[i], "-num_min") == 0)
+    {
+      num_min = atoi(argv[++i]);
+    }
+    else if (strcmp(argv[i], "-num_max") == 0)
+    {
+      num_max = atoi(argv[++i]);
+    }
+    else if (strcmp(argv[i], "-incr") == 0)
+    {
+      incr = atoi(argv[++i]);
+    }
+    else if (strcmp(argv[i], "-numP") == 0)
+    {
+      n_perms = atoi(argv[++i]);
+    }
+    else if (strcmp(argv[i], "-outputFile") == 0)
+    {
+      strcpy(nombre, argv[++i]);
+    }
+    else if (strcmp(argv[i], "-method") == 0)
+    {
+      strcpy(method, argv[++i]);
+    }
+    else if (strcmp(argv[i], "-shape") == 0)
+    {
+      strcpy(shape, argv[++i]);
+    }
+    else
+    {
+      fprintf(stderr, "Wrong paramenter %s\n", argv[i]);
+    }
+  }
+
+  if (strcmp(method, "pdqsort") == 0)
+    metodo = pdqsort;
+  else if (strcmp(method, "introsort") == 0)
+    metodo = introsort;
+  else
+    metodo = quicksort;
+
+  if (strcmp(shape, "sorted") == 0)
+    forma = SHAPE_SORTED;
+  else if (strcmp(shape, "reversed") == 0)
+    forma = SHAPE_REVERSED;
+  else if (strcmp(shape, "organ") == 0)
+    forma = SHAPE_ORGAN_PIPE;
+  else if (strcmp(shape, "prefix") == 0)
+    forma = SHAPE_SORTED_PREFIX;
+  else if (strcmp(shape, "few") == 0)
+    forma = SHAPE_FEW_UNIQUE;
+  else
+    forma = SHAPE_RANDOM;
+
+  set_input_shape(forma);
+
+  /* compute times */
+  ret = generate_sorting_times(metodo, nombre, num_min, num_max, incr, n_perms);
+  if (ret == ERR)
+  { /* ERR_TIME should be a negative number */
+    printf("Error in function generate_sorting_times\n");
+    exit(-1);
+  }
+  printf("Correct output \n");
+
+  return 0;
+}
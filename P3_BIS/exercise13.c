@@ -0,0 +1,119 @@
+/***********************************************************/
+/* Program: exercise13                 Date:               */
+/* Authors: Ignacio Sánchez and Fabio Desio                */
+/*                                                         */
+/* Programa that writes in a file                          */
+/* the average times of sorting doubles with radix sort    */
+/* or with the qsort of the C library                      */
+/*                                                         */
+/* Input: Command Line                                     */
+/* -num_min: lowest number of table elements               */
+/* -num_max: highest number of table elements              */
+/* -incr: increment\n                                      */
+/* -numP: number of permutations to average                */
+/* -outputFile: Output file name                           */
+/* -method: radix or qsort                                 */
+/* Output: 0 in case of error                              */
+/* -1 otherwise                                            */
+/***********************************************************/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include "sorting.h"
+#include "times.h"
+
+/* Comparaciones hechas por qsort_double */
+static long comparaciones;
+
+/* Comparison function of doubles for qsort */
+static int compare_double(const void *a, const void *b)
+{
+  double x = *(const double *)a, y = *(const double *)b;
+
+  comparaciones++;
+  return (x > y) - (x < y);
+}
+
+/* Comparison sort of doubles, its ob are the comparisons of qsort */
+static long qsort_double(double *tabla, long ip, long iu)
+{
+  comparaciones = 0;
+  qsort(tabla + ip, iu - ip + 1, sizeof(tabla[0]), compare_double);
+
+  return comparaciones;
+}
+
+int main(int argc, char **argv)
+{
+  int i, num_min, num_max, incr, n_perms;
+  char nombre[256], method[256];
+  short ret;
+
+  srand(time(NULL));
+
+  if (argc != 13)
+  {
+    fprintf(stderr, "Error in input parameters:\n\n");
+    fprintf(stderr, "%s -num_min <int> -num_max <int> -incr <int>\n", argv[0]);
+    fprintf(stderr, "\t\t -numP <int> -outputFile <string> -method <radix|qsort>\n");
+    fprintf(stderr, "Donde:\n");
+    fprintf(stderr, "-num_min: lowest number of table elements\n");
+    fprintf(stderr, "-num_max: highest number of table elements\n");
+    fprintf(stderr, "-incr: increment\n");
+    fprintf(stderr, "-numP: number of permutations to average\n");
+    fprintf(stderr, "-outputFile: Output file name\n");
+    fprintf(stderr, "-method: radix_sort_double or the qsort of the C library\n");
+    exit(-1);
+  }
+
+  printf("Practice number 1, section 13\n");
+  printf("Done by: your names\n");
+  printf("Group: Your group\n");
+
+  /* check command line */
+  for (i = 1; i < argc; i++)
+  {
+    if (strcmp(argv[i], "-num_min") == 0)
+    {
+      num_min = atoi(argv[++i]);
+    }
+    else if (strcmp(argv[i], "-num_max") == 0)
+    {
+      num_max = atoi(argv[++i]);
+    }
+    else if (strcmp(argv[i], "-incr") == 0)
+    {
+      incr = atoi(argv[++i]);
+    }
+    else if (strcmp(argv[i], "-numP") == 0)
+    {
+      n_perms = atoi(argv[++i]);
+    }
+    else if (strcmp(argv[i], "-outputFile") == 0)
+    {
+      strcpy(nombre, argv[++i]);
+    }
+    else if (strcmp(argv[i], "-method") == 0)
+    {
+      strcpy(method, argv[++i]);
+    }
+    else
+    {
+      fprintf(stderr, "Wrong paramenter %s\n", argv[i]);
+    }
+  }
+
+  /* compute times */
+  ret = generate_sorting_times_double(strcmp(method, "qsort") == 0 ? qsort_double : radix_sort_double,
+                                      nombre, num_min, num_max, incr, n_perms);
+  if (ret == ERR)
+  { /* ERR_TIME should be a negative number */
+    printf("Error in function generate_sorting_times_double\n");
+    exit(-1);
+  }
+  printf("Correct output \n");
+
+  return 0;
+}
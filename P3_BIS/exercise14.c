@@ -0,0 +1,133 @@
+/***********************************************************/
+/* Program: exercise14 Date:                            */
+/* Authors:                                                */
+/*                                                         */
+/* Program that writes in a file the average times         */
+/* of the search functions on the dictionary order each   */
+/* one needs                                               */
+/*                                                         */
+/* Input: Command line                                     */
+/* -num_min: minimum number of elements in the table       */
+/* -num_max: maximum number of elements in the table       */
+/* -incr: increment                                       */
+/* -fkeys: number of keys to search                        */
+/* -numP: Introduce the number of permutations to average  */
+/* -outputFile: Name of the output file                    */
+/* -method: bin, branchless, eytzinger, stree, interp,     */
+/*          guarded, gallop, batch, gather, parbatch, lin, */
+/*          simd, par or hash                              */
+/*                                                         */
+/* Output: 0 if there was an error                         */
+/*        -1 otherwise                                     */
+/***********************************************************/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include "permutations.h"
+#include "search.h"
+#include "times.h"
+
+/* Search functions (or batch searches) and the order of the dictionary
+ * they search */
+static const struct {
+  const char *name;
+  pfunc_search method;
+  pfunc_search_batch batch;
+  int order;
+} methods[] = {
+  {"bin", bin_search, NULL, SORTED},
+  {"branchless", branchless_search, NULL, SORTED},
+  {"eytzinger", eytzinger_search, NULL, EYTZINGER},
+  {"stree", stree_search, NULL, SORTED},
+  {"interp", interp_search, NULL, SORTED},
+  {"guarded", interp_guarded_search, NULL, SORTED},
+  {"gallop", gallop_search, NULL, SORTED},
+  /* Interleaved binary searches of search_dictionary_batch */
+  {"batch", NULL, search_dictionary_batch, SORTED},
+  /* Binary searches of 8 keys at a time with AVX2 gathers */
+  {"gather", NULL, simd_search_batch, SORTED},
+  /* Shards of the batch searched by the threads of the pool */
+  {"parbatch", NULL, par_search_batch, SORTED},
+  {"lin", lin_search, NULL, NOT_SORTED},
+  {"simd", simd_lin_search, NULL, NOT_SORTED},
+  {"par", par_lin_search, NULL, NOT_SORTED},
+  /* HASHED dictionaries probe their hash table whatever the method */
+  {"hash", lin_search, NULL, HASHED}
+};
+
+int main(int argc, char** argv)
+{
+  int i, m, num_min,num_max,incr,n_times;
+  char name[256], method[256];
+  short ret;
+ 
+  srand(time(NULL));
+
+  if (argc != 13) {
+    fprintf(stderr, "Error in the input parameters:\n\n");
+    fprintf(stderr, "%s -num_min <int> -num_max <int> -incr <int>\n", argv[0]);
+    fprintf(stderr, "\t\t -n_times <int> -outputFile <string> -method <method>\n");
+    fprintf(stderr, "Where:\n");
+    fprintf(stderr, "-num_min: minimum number of elements of the table\n");
+    fprintf(stderr, "-num_max: maximum number of elements of the table\n");
+    fprintf(stderr, "-incr: increment\n");
+    fprintf(stderr, "-n_times: number of times each key is searched\n");
+    fprintf(stderr, "-outputFile: Output file name\n");
+    fprintf(stderr, "-method: bin, branchless, eytzinger, stree, interp, guarded, gallop, batch, gather, parbatch, lin, simd, par or hash\n");
+    exit(-1);
+  }
+
+  printf("Practice number 3, section 14\n");
+  printf("Done by: Your names\n");
+  printf("Group: Your group\n");
+
+  /* check the command line */
+  for(i = 1; i < argc ; i++) {
+    if (strcmp(argv[i], "-num_min") == 0) {
+      num_min = atoi(argv[++i]);
+    } else if (strcmp(argv[i], "-num_max") == 0) {
+      num_max = atoi(argv[++i]);
+    } else if (strcmp(argv[i], "-incr") == 0) {
+      incr = atoi(argv[++i]);
+    } else if (strcmp(argv[i], "-n_times") == 0) {
+      n_times = atoi(argv[++i]);
+    } else if (strcmp(argv[i], "-outputFile") == 0) {
+      strcpy(name, argv[++i]);
+    } else if (strcmp(argv[i], "-method") == 0) {
+      strcpy(method, argv[++i]);
+    } else {
+      fprintf(stderr, "Parameter %s is invalid\n", argv[i]);
+      exit(-1);
+    }
+  }
+
+  for (m = 0; m < (int)(sizeof(methods) / sizeof(methods[0])); m++) {
+    if (strcmp(method, methods[m].name) == 0)
+      break;
+  }
+
+  if (m == (int)(sizeof(methods) / sizeof(methods[0]))) {
+    fprintf(stderr, "Method %s is invalid\n", method);
+    exit(-1);
+  }
+
+  /* calculamos los tiempos */
+  if (methods[m].method == NULL)
+    ret = generate_batch_search_times(methods[m].batch, uniform_key_generator64, methods[m].order,
+                                      name, num_min, num_max, incr, n_times);
+  else
+    ret = generate_search_times(methods[m].method, uniform_key_generator, methods[m].order,
+                                name, num_min, num_max, incr, n_times);
+  free_default_pool();
+  if (ret == ERR) { 
+    printf("Error in function generate_search_times\n");
+    exit(-1);
+  }
+
+  printf("Correct output \n");
+
+  return 0;
+}
+
@@ -0,0 +1,78 @@
+/***********************************************************/
+/* Program: exercise15                 Date:               */
+/* Authors: Ignacio Sánchez and Fabio Desio                */
+/*                                                         */
+/* Program that writes in a file the throughput of the     */
+/* parallel batch search of a sorted dictionary with 1, 2, */
+/* ... threads                                             */
+/*                                                         */
+/* Input: Command line                                     */
+/* -num: number of elements in the table                   */
+/* -n_times: number of times each key is searched          */
+/* -max_threads: maximum number of threads, 0 for one per  */
+/*               online CPU                                */
+/* -outputFile: Name of the output file                    */
+/*                                                         */
+/* Output: 0 if there was an error                         */
+/*        -1 otherwise                                     */
+/***********************************************************/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include "permutations.h"
+#include "search.h"
+#include "times.h"
+
+int main(int argc, char** argv)
+{
+  int i, num, n_times, max_threads;
+  char name[256];
+  short ret;
+
+  srand(time(NULL));
+
+  if (argc != 9) {
+    fprintf(stderr, "Error in the input parameters:\n\n");
+    fprintf(stderr, "%s -num <int> -n_times <int> -max_threads <int> -outputFile <string>\n", argv[0]);
+    fprintf(stderr, "Where:\n");
+    fprintf(stderr, "-num: number of elements of the table\n");
+    fprintf(stderr, "-n_times: number of times each key is searched\n");
+    fprintf(stderr, "-max_threads: maximum number of threads, 0 for one per online CPU\n");
+    fprintf(stderr, "-outputFile: Output file name\n");
+    exit(-1);
+  }
+
+  printf("Practice number 3, section 15\n");
+  printf("Done by: Your names\n");
+  printf("Group: Your group\n");
+
+  /* check the command line */
+  for(i = 1; i < argc ; i++) {
+    if (strcmp(argv[i], "-num") == 0) {
+      num = atoi(argv[++i]);
+    } else if (strcmp(argv[i], "-n_times") == 0) {
+      n_times = atoi(argv[++i]);
+    } else if (strcmp(argv[i], "-max_threads") == 0) {
+      max_threads = atoi(argv[++i]);
+    } else if (strcmp(argv[i], "-outputFile") == 0) {
+      strcpy(name, argv[++i]);
+    } else {
+      fprintf(stderr, "Parameter %s is invalid\n", argv[i]);
+      exit(-1);
+    }
+  }
+
+  /* calculamos los tiempos */
+  ret = generate_scaling_times(uniform_key_generator64, SORTED, name, num, n_times, max_threads);
+  free_default_pool();
+  if (ret == ERR) { 
+    printf("Error in function generate_scaling_times\n");
+    exit(-1);
+  }
+
+  printf("Correct output \n");
+
+  return 0;
+}
@@ -0,0 +1,109 @@
+/***********************************************************/
+/* Program: exercise8                  Date:               */
+/* Authors: Ignacio Sánchez and Fabio Desio                */
+/*                                                         */
+/* Program that writes in a file the average times         */
+/* of adaptive_sort and in another file the engine         */
+/* chosen for each permutation                             */
+/*                                                         */
+/* Input: Command Line                                     */
+/* -num_min: lowest number of table elements               */
+/* -num_max: highest number of table elements              */
+/* -incr: increment                                        */
+/* -numP: number of permutations to average                */
+/* -outputFile: Output file name                           */
+/* -logFile: File with the decisions of adaptive_sort      */
+/* Output: 0 in case of error                              */
+/* -1 otherwise                                            */
+/***********************************************************/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include "sorting.h"
+#include "times.h"
+
+int main(int argc, char **argv)
+{
+  int i, num_min, num_max, incr, n_perms;
+  char nombre[256], log[256];
+  short ret;
+  FILE *pf;
+
+  srand(time(NULL));
+
+  if (argc != 13)
+  {
+    fprintf(stderr, "Error in input parameters:\n\n");
+    fprintf(stderr, "%s -num_min <int> -num_max <int> -incr <int>\n", argv[0]);
+    fprintf(stderr, "\t\t -numP <int> -outputFile <string> -logFile <string>\n");
+    fprintf(stderr, "Donde:\n");
+    fprintf(stderr, "-num_min: lowest number of table elements\n");
+    fprintf(stderr, "-num_max: highest number of table elements\n");
+    fprintf(stderr, "-incr: increment\n");
+    fprintf(stderr, "-numP: number of permutations to average\n");
+    fprintf(stderr, "-outputFile: Output file name\n");
+    fprintf(stderr, "-logFile: File with the decisions of adaptive_sort\n");
+    exit(-1);
+  }
+
+  printf("Practice number 1, section 8\n");
+  printf("Done by: Ignacio Sánchez and Fabio Desio\n");
+  printf("Group: Your group\n");
+
+  /* check command line */
+  for (i = 1; i < argc; i++)
+  {
+    if (strcmp(argv[i], "-num_min") == 0)
+    {
+      num_min = atoi(argv[++i]);
+    }
+    else if (strcmp(argv[i], "-num_max") == 0)
+    {
+      num_max = atoi(argv[++i]);
+    }
+    else if (strcmp(argv[i], "-incr") == 0)
+    {
+      incr = atoi(argv[++i]);
+    }
+    else if (strcmp(argv[i], "-numP") == 0)
+    {
+      n_perms = atoi(argv[++i]);
+    }
+    else if (strcmp(argv[i], "-outputFile") == 0)
+    {
+      strcpy(nombre, argv[++i]);
+    }
+    else if (strcmp(argv[i], "-logFile") == 0)
+    {
+      strcpy(log, argv[++i]);
+    }
+    else
+    {
+      fprintf(stderr, "Wrong paramenter %s\n", argv[i]);
+    }
+  }
+
+  /* Cada línea: N runs inv_ratio dup_ratio min max engine */
+  pf = fopen(log, "w");
+  if (pf == NULL)
+  {
+    printf("Error opening %s\n", log);
+    exit(-1);
+  }
+  adaptive_sort_log(pf);
+
+  /* compute times */
+  ret = generate_sorting_times(adaptive_sort, nombre, num_min, num_max, incr, n_perms);
+  adaptive_sort_log(NULL);
+  fclose(pf);
+  if (ret == ERR)
+  { /* ERR_TIME should be a negative number */
+    printf("Error in function generate_sorting_times\n");
+    exit(-1);
+  }
+  printf("Correct output \n");
+
+  return 0;
+}
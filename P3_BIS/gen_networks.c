@@ -0,0 +1,522 @@
+/**
+ *
+ * Descripcion: Generator of the sorting networks of networks.c. Writes to
+ *              the standard output one branch-free function for each size
+ *              from 2 to SORTNET_MAX and checks every network before 
+ *              writing it
+ *
+ * Fichero: gen_networks.c
+ * Autor: Ignacio Sánchez and Fabio Desio
+ * Version: 1.0
+ * Fecha: 18-10-2026
+ *
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <limits.h>
+#include "networks.h"
+
+/* Comparadores como mucho de una red de SORTNET_MAX elementos */
+#define MAX_CMP 1024
+
+/* Tamaño hasta el que la comprobación es exhaustiva (principio del 0-1) */
+#define EXHAUSTIVE_MAX 24
+#define RANDOM_TESTS 100000
+
+/* Entradas 0-1 comprobadas a la vez, una por bit */
+#define WORD_BITS ((int)(sizeof(unsigned long) * CHAR_BIT))
+
+typedef struct network {
+  int n;           /* number of elements */
+  int n_cmp;       /* number of comparators */
+  int ci[MAX_CMP]; /* first (smaller) index of each comparator */
+  int cj[MAX_CMP]; /* second index of each comparator */
+} NETWORK;
+
+/* Mejores redes conocidas, óptimas hasta 10 elementos: 2 a 8 de Knuth
+ * (TAOCP vol. 3, 5.3.4), 12 de Shapiro y Green, 16 de Green y las demás
+ * con los comparadores de la lista de redes de Bert Dobbelaere. La de 22
+ * (108, uno más que la mejor conocida) sale de quitar dos cables a la de 24
+ * y la de 30 de quitar dos cables a la de 32 de split_merge */
+static const int known2[] = {0, 1};
+static const int known3[] = {0, 2, 0, 1, 1, 2};
+static const int known4[] = {0, 1, 2, 3, 0, 2, 1, 3, 1, 2};
+static const int known5[] = {0, 1, 3, 4, 2, 4, 2, 3, 0, 3, 0, 2, 1, 4, 1, 3, 1, 2};
+static const int known6[] = {1, 2, 4, 5, 0, 2, 3, 5, 0, 1, 3, 4, 2, 5, 0, 3, 1, 4,
+                             2, 4, 1, 3, 2, 3};
+static const int known7[] = {1, 2, 3, 4, 5, 6, 0, 2, 3, 5, 4, 6, 0, 1, 4, 5, 2, 6,
+                             0, 4, 1, 5, 0, 3, 2, 5, 1, 3, 2, 4, 2, 3};
+static const int known8[] = {0, 2, 1, 3, 4, 6, 5, 7, 0, 4, 1, 5, 2, 6, 3, 7, 0, 1,
+                             2, 3, 4, 5, 6, 7, 2, 4, 3, 5, 1, 4, 3, 6, 1, 2, 3, 4,
+                             5, 6};
+static const int known9[] = {0, 3, 1, 7, 2, 5, 4, 8, 0, 7, 2, 4, 3, 8, 5, 6, 0, 2,
+                             1, 3, 4, 5, 7, 8, 1, 4, 3, 6, 5, 7, 0, 1, 2, 4, 3, 5,
+                             6, 8, 2, 3, 4, 5, 6, 7, 1, 2, 3, 4, 5, 6};
+static const int known10[] = {0, 8, 1, 9, 2, 7, 3, 5, 4, 6, 0, 2, 1, 4, 5, 8, 7, 9,
+                              0, 3, 2, 4, 5, 7, 6, 9, 0, 1, 3, 6, 8, 9, 1, 5, 2, 3,
+                              4, 8, 6, 7, 1, 2, 3, 5, 4, 6, 7, 8, 2, 3, 4, 5, 6, 7,
+                              3, 4, 5, 6};
+static const int known12[] = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 1, 3, 5, 7, 9,
+                              11, 0, 2, 4, 6, 8, 10, 1, 2, 5, 6, 9, 10, 0, 4, 7, 11,
+                              1, 5, 6, 10, 3, 7, 4, 8, 5, 9, 2, 6, 0, 4, 7, 11, 3,
+                              8, 1, 5, 6, 10, 2, 3, 8, 9, 1, 4, 7, 10, 3, 5, 6, 8,
+                              2, 4, 7, 9, 5, 6, 3, 4, 7, 8};
+static const int known13[] = {0, 12, 1, 10, 2, 9, 3, 7, 5, 11, 6, 8, 1, 6, 2, 3, 4,
+                              11, 7, 9, 8, 10, 0, 4, 1, 2, 3, 6, 7, 8, 9, 10, 11,
+                              12, 4, 6, 5, 9, 8, 11, 10, 12, 0, 5, 3, 8, 4, 7, 6,
+                              11, 9, 10, 0, 1, 2, 5, 6, 9, 7, 8, 10, 11, 1, 3, 2, 4,
+                              5, 6, 9, 10, 1, 2, 3, 4, 5, 7, 6, 8, 2, 3, 4, 5, 6, 7,
+                              8, 9, 3, 4, 5, 6};
+static const int known16[] = {0, 13, 1, 12, 2, 15, 3, 14, 4, 8, 5, 6, 7, 11, 9, 10,
+                              0, 5, 1, 7, 2, 9, 3, 4, 6, 13, 8, 14, 10, 15, 11, 12,
+                              0, 1, 2, 3, 4, 5, 6, 8, 7, 9, 10, 11, 12, 13, 14, 15,
+                              0, 2, 1, 3, 4, 10, 5, 11, 6, 7, 8, 9, 12, 14, 13, 15,
+                              1, 2, 3, 12, 4, 6, 5, 7, 8, 10, 9, 11, 13, 14, 1, 4,
+                              2, 6, 5, 8, 7, 10, 9, 13, 11, 14, 2, 4, 3, 6, 9, 12,
+                              11, 13, 3, 5, 6, 8, 7, 9, 10, 12, 3, 4, 5, 6, 7, 8, 9,
+                              10, 11, 12, 6, 7, 8, 9};
+static const int known17[] = {0, 11, 1, 15, 2, 10, 3, 5, 4, 6, 8, 12, 9, 16, 13, 14,
+                              0, 6, 1, 13, 2, 8, 4, 14, 5, 15, 7, 11, 0, 8, 3, 7, 4,
+                              9, 6, 16, 10, 11, 12, 14, 0, 2, 1, 4, 5, 6, 7, 13, 8,
+                              9, 10, 12, 11, 14, 15, 16, 0, 3, 2, 5, 6, 11, 7, 10,
+                              9, 13, 12, 15, 14, 16, 0, 1, 3, 4, 5, 10, 6, 9, 7, 8,
+                              11, 15, 13, 14, 1, 2, 3, 7, 4, 8, 6, 12, 11, 13, 14,
+                              15, 1, 3, 2, 7, 4, 5, 9, 11, 10, 12, 13, 14, 2, 3, 4,
+                              6, 5, 7, 8, 10, 3, 4, 6, 8, 7, 9, 10, 12, 5, 6, 7, 8,
+                              9, 10, 11, 12, 4, 5, 6, 7, 8, 9, 12, 13, 10, 11};
+static const int known18[] = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15,
+                              16, 17, 1, 5, 2, 6, 3, 7, 4, 10, 8, 16, 9, 17, 12, 14,
+                              13, 15, 0, 8, 1, 10, 2, 12, 3, 14, 6, 13, 7, 15, 9,
+                              16, 11, 17, 0, 4, 1, 9, 5, 17, 8, 11, 10, 16, 0, 2, 1,
+                              6, 4, 10, 5, 9, 14, 16, 15, 17, 1, 2, 3, 10, 4, 12, 5,
+                              7, 6, 14, 9, 13, 15, 16, 3, 8, 5, 12, 7, 11, 9, 10, 3,
+                              4, 6, 8, 7, 14, 9, 12, 11, 13, 1, 3, 2, 4, 7, 9, 8,
+                              12, 11, 15, 13, 16, 2, 3, 4, 5, 6, 7, 10, 11, 12, 14,
+                              13, 15, 4, 6, 5, 8, 9, 10, 11, 14, 3, 4, 5, 7, 8, 9,
+                              10, 12, 13, 14, 5, 6, 7, 8, 9, 10, 11, 12};
+static const int known19[] = {0, 12, 1, 4, 2, 8, 3, 5, 6, 17, 7, 11, 9, 14, 10, 13,
+                              15, 16, 0, 2, 1, 7, 3, 6, 4, 11, 5, 17, 8, 12, 10, 15,
+                              13, 16, 14, 18, 3, 10, 4, 14, 5, 15, 6, 13, 7, 9, 11,
+                              17, 16, 18, 0, 7, 1, 10, 4, 6, 9, 15, 11, 16, 12, 17,
+                              13, 14, 0, 3, 2, 6, 5, 7, 8, 11, 12, 16, 1, 8, 2, 9,
+                              3, 4, 6, 15, 7, 13, 10, 11, 12, 18, 1, 3, 2, 5, 6, 9,
+                              7, 12, 8, 10, 11, 14, 17, 18, 0, 1, 2, 3, 4, 8, 6, 10,
+                              9, 12, 14, 15, 16, 17, 1, 2, 5, 8, 6, 7, 9, 11, 10,
+                              13, 14, 16, 15, 17, 3, 6, 4, 5, 7, 9, 8, 10, 11, 12,
+                              13, 14, 15, 16, 3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 12,
+                              14, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15};
+static const int known20[] = {0, 3, 1, 7, 2, 5, 4, 8, 6, 9, 10, 13, 11, 15, 12, 18,
+                              14, 17, 16, 19, 0, 14, 1, 11, 2, 16, 3, 17, 4, 12, 5,
+                              19, 6, 10, 7, 15, 8, 18, 9, 13, 1, 2, 0, 4, 12, 14, 3,
+                              8, 11, 16, 5, 7, 15, 19, 1, 6, 17, 18, 3, 5, 13, 18,
+                              7, 17, 4, 11, 2, 12, 8, 15, 0, 1, 14, 16, 2, 6, 7, 10,
+                              1, 6, 9, 12, 13, 17, 5, 9, 4, 7, 10, 14, 18, 19, 8,
+                              12, 13, 18, 7, 11, 3, 5, 8, 10, 9, 11, 12, 15, 1, 3,
+                              14, 16, 15, 17, 9, 13, 6, 10, 12, 14, 16, 18, 8, 9, 2,
+                              4, 1, 2, 6, 7, 3, 4, 5, 7, 15, 16, 12, 13, 10, 11, 17,
+                              18, 13, 15, 4, 6, 9, 12, 7, 10, 11, 14, 5, 8, 6, 8,
+                              16, 17, 7, 9, 4, 5, 14, 15, 2, 3, 10, 12, 15, 16, 11,
+                              13, 11, 12, 13, 14, 3, 4, 9, 10, 5, 6, 7, 8};
+static const int known21[] = {0, 7, 1, 10, 3, 5, 4, 8, 6, 13, 9, 19, 11, 14, 12, 17,
+                              15, 16, 18, 20, 0, 11, 1, 15, 2, 12, 3, 4, 5, 8, 6, 9,
+                              7, 14, 10, 16, 13, 19, 17, 20, 0, 6, 1, 3, 2, 18, 4,
+                              15, 5, 10, 8, 16, 11, 17, 12, 13, 14, 20, 2, 6, 5, 12,
+                              7, 18, 8, 14, 9, 11, 10, 17, 13, 19, 16, 20, 1, 2, 4,
+                              7, 5, 9, 6, 17, 10, 13, 11, 12, 14, 19, 15, 18, 0, 2,
+                              3, 6, 4, 5, 7, 10, 8, 11, 9, 15, 12, 16, 13, 18, 14,
+                              17, 19, 20, 0, 1, 2, 3, 5, 9, 6, 12, 7, 8, 11, 14, 13,
+                              15, 16, 19, 17, 18, 1, 2, 3, 9, 6, 13, 10, 11, 12, 15,
+                              16, 17, 18, 19, 1, 4, 2, 5, 3, 7, 6, 10, 8, 9, 11, 12,
+                              13, 14, 17, 18, 2, 4, 5, 6, 7, 8, 9, 11, 10, 13, 12,
+                              15, 14, 16, 3, 4, 5, 7, 6, 8, 9, 10, 11, 13, 12, 14,
+                              15, 16, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16,
+                              17};
+static const int known22[] = {0, 18, 1, 10, 2, 21, 3, 8, 5, 19, 6, 12, 7, 13, 9, 20,
+                              11, 16, 15, 17, 0, 2, 1, 9, 3, 11, 4, 17, 6, 7, 8, 16,
+                              10, 20, 12, 13, 14, 19, 18, 21, 0, 1, 2, 10, 3, 6, 4,
+                              7, 5, 8, 9, 18, 11, 14, 12, 15, 13, 16, 17, 19, 20,
+                              21, 4, 9, 5, 12, 7, 14, 10, 15, 13, 17, 16, 19, 1, 6,
+                              2, 12, 7, 18, 8, 10, 9, 11, 13, 20, 14, 17, 0, 5, 14,
+                              21, 1, 3, 4, 9, 6, 13, 7, 12, 8, 11, 10, 15, 16, 20,
+                              17, 18, 1, 4, 2, 5, 3, 7, 6, 8, 11, 13, 12, 16, 14,
+                              17, 15, 20, 19, 21, 2, 3, 4, 6, 5, 7, 8, 9, 10, 11,
+                              12, 14, 13, 15, 16, 17, 18, 19, 0, 4, 2, 8, 5, 6, 7,
+                              9, 10, 12, 11, 17, 13, 14, 15, 18, 19, 20, 0, 1, 3, 8,
+                              4, 5, 6, 7, 11, 16, 12, 13, 14, 15, 18, 19, 1, 2, 3,
+                              5, 8, 10, 9, 11, 14, 16, 17, 18, 2, 4, 6, 8, 7, 10, 9,
+                              12, 11, 13, 15, 17, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12,
+                              13, 14, 15, 16};
+static const int known24[] = {0, 20, 1, 12, 2, 16, 3, 23, 4, 6, 5, 10, 7, 21, 8, 14,
+                              9, 15, 11, 22, 13, 18, 17, 19, 0, 3, 1, 11, 2, 7, 4,
+                              17, 5, 13, 6, 19, 8, 9, 10, 18, 12, 22, 14, 15, 16,
+                              21, 20, 23, 0, 1, 2, 4, 3, 12, 5, 8, 6, 9, 7, 10, 11,
+                              20, 13, 16, 14, 17, 15, 18, 19, 21, 22, 23, 2, 5, 4,
+                              8, 6, 11, 7, 14, 9, 16, 12, 17, 15, 19, 18, 21, 1, 8,
+                              3, 14, 4, 7, 9, 20, 10, 12, 11, 13, 15, 22, 16, 19, 0,
+                              7, 16, 23, 1, 5, 3, 4, 6, 11, 8, 15, 9, 14, 10, 13,
+                              12, 17, 18, 22, 19, 20, 0, 2, 1, 6, 4, 7, 5, 9, 8, 10,
+                              13, 15, 14, 18, 16, 19, 17, 22, 21, 23, 2, 3, 4, 5, 6,
+                              8, 7, 9, 10, 11, 12, 13, 14, 16, 15, 17, 18, 19, 20,
+                              21, 1, 2, 3, 6, 4, 10, 7, 8, 9, 11, 12, 14, 13, 19,
+                              15, 16, 17, 20, 21, 22, 2, 3, 5, 10, 6, 7, 8, 9, 13,
+                              18, 14, 15, 16, 17, 20, 21, 3, 4, 5, 7, 10, 12, 11,
+                              13, 16, 18, 19, 20, 4, 6, 8, 10, 9, 12, 11, 14, 13,
+                              15, 17, 19, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16,
+                              17, 18};
+static const int known30[] = {0, 11, 1, 14, 2, 13, 3, 7, 4, 5, 6, 10, 8, 9, 0, 6, 1,
+                              8, 2, 3, 5, 12, 7, 13, 9, 14, 10, 11, 1, 2, 3, 4, 5,
+                              7, 6, 8, 9, 10, 11, 12, 13, 14, 0, 2, 3, 9, 4, 10, 5,
+                              6, 7, 8, 11, 13, 12, 14, 0, 1, 2, 11, 3, 5, 4, 6, 7,
+                              9, 8, 10, 12, 13, 0, 3, 1, 5, 4, 7, 6, 9, 8, 12, 10,
+                              13, 1, 3, 2, 5, 8, 11, 10, 12, 2, 4, 5, 7, 6, 8, 9,
+                              11, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 5, 6, 7, 8, 15,
+                              26, 16, 29, 17, 28, 18, 22, 19, 20, 21, 25, 23, 24,
+                              15, 21, 16, 23, 17, 18, 20, 27, 22, 28, 24, 29, 25,
+                              26, 16, 17, 18, 19, 20, 22, 21, 23, 24, 25, 26, 27,
+                              28, 29, 15, 17, 18, 24, 19, 25, 20, 21, 22, 23, 26,
+                              28, 27, 29, 15, 16, 17, 26, 18, 20, 19, 21, 22, 24,
+                              23, 25, 27, 28, 15, 18, 16, 20, 19, 22, 21, 24, 23,
+                              27, 25, 28, 16, 18, 17, 20, 23, 26, 25, 27, 17, 19,
+                              20, 22, 21, 23, 24, 26, 17, 18, 19, 20, 21, 22, 23,
+                              24, 25, 26, 20, 21, 22, 23, 7, 22, 3, 18, 11, 26, 11,
+                              18, 7, 11, 18, 22, 1, 16, 9, 24, 9, 16, 5, 20, 13, 28,
+                              13, 20, 5, 9, 13, 16, 20, 24, 3, 5, 7, 9, 11, 13, 16,
+                              18, 20, 22, 24, 26, 0, 15, 8, 23, 8, 15, 4, 19, 12,
+                              27, 12, 19, 4, 8, 12, 15, 19, 23, 2, 17, 10, 25, 10,
+                              17, 6, 21, 14, 29, 14, 21, 6, 10, 14, 17, 21, 25, 2,
+                              4, 6, 8, 10, 12, 14, 15, 17, 19, 21, 23, 25, 27, 1, 2,
+                              3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17,
+                              18, 19, 20, 21, 22, 23, 24, 25, 26, 27, 28};
+
+static const int *known[] = {NULL, NULL, known2, known3, known4, known5, known6,
+                             known7, known8, known9, known10, NULL, known12,
+                             known13, NULL, NULL, known16, known17, known18,
+                             known19, known20, known21, known22, NULL, known24,
+                             NULL, NULL, NULL, NULL, NULL, known30};
+static const int known_cmp[] = {0, 0, 1, 3, 5, 9, 12, 16, 19, 25, 29, 0, 39, 45, 0,
+                                0, 60, 71, 77, 85, 91, 100, 108, 0, 120, 0, 0, 0, 0,
+                                0, 172};
+
+#define N_KNOWN ((int)(sizeof(known) / sizeof(known[0])))
+
+static NETWORK best[SORTNET_MAX + 1];
+
+/**
+ * Adds the comparator (i, j) to the network if both wires exist
+ * @param net pointer to the network
+ * @param i first wire
+ * @param j second wire
+ */
+static void add(NETWORK *net, int i, int j)
+{
+  if (i >= net->n || j >= net->n)
+    return;
+
+  net->ci[net->n_cmp] = i;
+  net->cj[net->n_cmp] = j;
+  net->n_cmp++;
+}
+
+/**
+ * Batcher's merge exchange network for n elements
+ * (Knuth, TAOCP vol. 3, algorithm 5.2.2M). Only a fallback for the sizes
+ * without a table in known[]
+ * @param net pointer to the network built
+ * @param n number of elements
+ */
+static void merge_exchange(NETWORK *net, int n)
+{
+  int t, p, q, r, d, i;
+
+  net->n = n;
+  net->n_cmp = 0;
+
+  for (t = 0; (1 << t) < n; t++)
+    ;
+
+  for (p = 1 << (t - 1); p > 0; p >>= 1)
+  {
+    q = 1 << (t - 1);
+    r = 0;
+    d = p;
+    while (d > 0)
+    {
+      for (i = 0; i < n - d; i++)
+      {
+        if ((i & p) == r)
+          add(net, i, i + d);
+      }
+      d = q - p;
+      q >>= 1;
+      r = p;
+    }
+  }
+}
+
+/**
+ * Batcher's odd-even merge of the wires lo, lo+r, lo+2r, ... of a block of
+ * size m (power of two). Comparators on wires >= net->n are dropped, which
+ * is valid because those wires would hold +infinity
+ * @param net pointer to the network
+ * @param lo first wire
+ * @param m size of the block
+ * @param r distance between wires
+ */
+static void odd_even_merge(NETWORK *net, int lo, int m, int r)
+{
+  int step = r * 2, i;
+
+  if (step < m)
+  {
+    odd_even_merge(net, lo, m, step);
+    odd_even_merge(net, lo + r, m, step);
+    for (i = lo + r; i + r < lo + m; i += step)
+      add(net, i, i + r);
+  }
+  else
+  {
+    add(net, lo, lo + r);
+  }
+}
+
+/**
+ * Network that sorts the lower half (a power of two) and the upper half
+ * with the best networks already known and merges them with odd_even_merge.
+ * Only a fallback for the sizes without a table in known[]
+ * @param net pointer to the network built
+ * @param n number of elements
+ */
+static void split_merge(NETWORK *net, int n)
+{
+  int half, m, c;
+
+  for (m = 1; m < n; m <<= 1)
+    ;
+  half = m / 2;
+
+  net->n = n;
+  net->n_cmp = 0;
+
+  for (c = 0; c < best[half].n_cmp; c++)
+    add(net, best[half].ci[c], best[half].cj[c]);
+  for (c = 0; c < best[n - half].n_cmp; c++)
+    add(net, half + best[n - half].ci[c], half + best[n - half].cj[c]);
+
+  odd_even_merge(net, 0, m, 1);
+}
+
+/**
+ * Applies the network to an array of n integers
+ * @param net pointer to the network
+ * @param a array
+ */
+static void apply(const NETWORK *net, int *a)
+{
+  int c, x, y;
+
+  for (c = 0; c < net->n_cmp; c++)
+  {
+    x = a[net->ci[c]];
+    y = a[net->cj[c]];
+    a[net->ci[c]] = x < y ? x : y;
+    a[net->cj[c]] = x < y ? y : x;
+  }
+}
+
+/**
+ * Checks that the network sorts: with every 0-1 input up to EXHAUSTIVE_MAX
+ * elements (0-1 principle) and with random inputs for bigger sizes. The
+ * 0-1 inputs go in parallel, one per bit of an unsigned long: input x has
+ * the bit i of x on wire i
+ * @param net pointer to the network
+ * @return 1 if the network sorts, 0 otherwise
+ */
+static int check(const NETWORK *net)
+{
+  unsigned long w[SORTNET_MAX], low[SORTNET_MAX], x, y;
+  int a[SORTNET_MAX], i, c, lb;
+  long v, n_words;
+
+  if (net->n > EXHAUSTIVE_MAX)
+  {
+    for (v = 0; v < RANDOM_TESTS; v++)
+    {
+      for (i = 0; i < net->n; i++)
+        a[i] = rand() % net->n;
+
+      apply(net, a);
+
+      for (i = 1; i < net->n; i++)
+      {
+        if (a[i - 1] > a[i])
+          return 0;
+      }
+    }
+
+    return 1;
+  }
+
+  /* Cables que cambian dentro de una palabra: bit i de la posición */
+  for (lb = 0; (1L << lb) < WORD_BITS && lb < net->n; lb++)
+  {
+    low[lb] = 0;
+    for (i = 0; i < WORD_BITS; i++)
+      low[lb] |= (unsigned long)((i >> lb) & 1) << i;
+  }
+
+  n_words = net->n > lb ? 1L << (net->n - lb) : 1;
+  for (v = 0; v < n_words; v++)
+  {
+    for (i = 0; i < net->n; i++)
+      w[i] = i < lb ? low[i] : ((v >> (i - lb)) & 1) ? ~0UL : 0UL;
+
+    for (c = 0; c < net->n_cmp; c++)
+    {
+      x = w[net->ci[c]];
+      y = w[net->cj[c]];
+      w[net->ci[c]] = x & y;
+      w[net->cj[c]] = x | y;
+    }
+
+    /* Ordenada si ningún cable tiene un 1 donde el siguiente tiene un 0 */
+    for (i = 1; i < net->n; i++)
+    {
+      if (w[i - 1] & ~w[i])
+        return 0;
+    }
+  }
+
+  return 1;
+}
+
+int main(void)
+{
+  NETWORK candidate;
+  int n, m, c;
+
+  srand(1);
+
+  /* Batcher sólo queda para los tamaños sin tabla */
+  for (n = 2; n <= SORTNET_MAX; n++)
+    merge_exchange(&best[n], n);
+
+  /* Tablas de mejores redes, y las que salen de quitarles los cables superiores */
+  for (m = 2; m < N_KNOWN; m++)
+  {
+    if (known[m] == NULL)
+      continue;
+
+    for (n = 2; n <= m; n++)
+    {
+      candidate.n = n;
+      candidate.n_cmp = 0;
+      for (c = 0; c < known_cmp[m]; c++)
+        add(&candidate, known[m][2 * c], known[m][2 * c + 1]);
+      if (candidate.n_cmp <= best[n].n_cmp)
+        best[n] = candidate;
+    }
+  }
+
+  /* Alternativa para los tamaños sin tabla: mezcla de las mejores redes de
+   * las dos mitades */
+  for (n = 3; n <= SORTNET_MAX; n++)
+  {
+    split_merge(&candidate, n);
+    if (candidate.n_cmp < best[n].n_cmp)
+      best[n] = candidate;
+  }
+
+  for (n = 2; n <= SORTNET_MAX; n++)
+  {
+    if (!check(&best[n]))
+    {
+      fprintf(stderr, "gen_networks: the network of size %d does not sort\n", n);
+      return EXIT_FAILURE;
+    }
+  }
+
+  printf("/**\n");
+  printf(" *\n");
+  printf(" * Descripcion: Sorting networks from 2 to %d elements\n", SORTNET_MAX);
+  printf(" *\n");
+  printf(" * Fichero: networks.c\n");
+  printf(" * Generated by gen_networks, do not edit\n");
+  printf(" *\n");
+  printf(" */\n\n");
+  printf("#include <assert.h>\n");
+  printf("#include \"networks.h\"\n\n");
+  printf("/* Compare-exchange without branches */\n");
+  printf("#define CE(i, j) { int x = a[i], y = a[j]; a[i] = x < y ? x : y; a[j] = x < y ? y : x; }\n\n");
+
+  for (n = 2; n <= SORTNET_MAX; n++)
+  {
+    printf("/* %d elements, %d comparators */\n", n, best[n].n_cmp);
+    printf("static void sortnet_%d(int *a)\n{\n", n);
+    for (c = 0; c < best[n].n_cmp; c++)
+      printf("  CE(%d, %d)\n", best[n].ci[c], best[n].cj[c]);
+    printf("}\n\n");
+
+    printf("static const int ci_%d[] = {", n);
+    for (c = 0; c < best[n].n_cmp; c++)
+      printf(c == 0 ? "%d" : ", %d", best[n].ci[c]);
+    printf("};\n");
+    printf("static const int cj_%d[] = {", n);
+    for (c = 0; c < best[n].n_cmp; c++)
+      printf(c == 0 ? "%d" : ", %d", best[n].cj[c]);
+    printf("};\n\n");
+  }
+
+  printf("static void (*const sortnets[])(int *) = {\n  0, 0");
+  for (n = 2; n <= SORTNET_MAX; n++)
+    printf(", sortnet_%d", n);
+  printf("};\n\n");
+
+  printf("static const int n_comparators[] = {\n  0, 0");
+  for (n = 2; n <= SORTNET_MAX; n++)
+    printf(", %d", best[n].n_cmp);
+  printf("};\n\n");
+
+  printf("static const int *const first_wires[] = {\n  0, 0");
+  for (n = 2; n <= SORTNET_MAX; n++)
+    printf(", ci_%d", n);
+  printf("};\n\n");
+
+  printf("static const int *const second_wires[] = {\n  0, 0");
+  for (n = 2; n <= SORTNET_MAX; n++)
+    printf(", cj_%d", n);
+  printf("};\n\n");
+
+  printf("%s", 
+"int sorting_network(int *tabla, int ip, int iu)\n"
+"{\n"
+"  int n;\n"
+"\n"
+"  assert(tabla != NULL);\n"
+"  assert(ip >= 0);\n"
+"  assert(iu >= ip);\n"
+"  assert(iu - ip < SORTNET_MAX);\n"
+"\n"
+"  n = iu - ip + 1;\n"
+"  if (n < 2)\n"
+"    return 0;\n"
+"\n"
+"  sortnets[n](tabla + ip);\n"
+"\n"
+"  return n_comparators[n];\n"
+"}\n"
+"\n"
+"int sortnet_comparators(int n, const int **ci, const int **cj)\n"
+"{\n"
+"  assert(n >= 0 && n <= SORTNET_MAX);\n"
+"\n"
+"  if (ci != NULL)\n"
+"    *ci = first_wires[n];\n"
+"  if (cj != NULL)\n"
+"    *cj = second_wires[n];\n"
+"\n"
+"  return n_comparators[n];\n"
+"}\n");
+
+  return EXIT_SUCCESS;
+}
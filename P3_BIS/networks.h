@@ -0,0 +1,31 @@
+/**
+ *
+ * Descripcion: Header file for the sorting networks generated by 
+ *              gen_networks in networks.c
+ *
+ * Fichero: networks.h
+ * Autor: Ignacio Sánchez and Fabio Desio
+ * Version: 1.0
+ * Fecha: 18-10-2026
+ *
+ */
+
+#ifndef NETWORKS_H
+#define NETWORKS_H
+
+#include <stddef.h>
+
+/* biggest size with a sorting network */
+#define SORTNET_MAX 32
+
+/* Functions */
+
+/* Sorts tabla[ip..iu] (at most SORTNET_MAX elements) with the network of 
+ * its size. Returns the number of comparators, one ob each */
+int sorting_network(int *tabla, int ip, int iu);
+
+/* Returns the number of comparators of the network of n elements and, if
+ * ci and cj are not NULL, the wires of each comparator (ci[c] < cj[c]) */
+int sortnet_comparators(int n, const int **ci, const int **cj);
+
+#endif
@@ -0,0 +1,76 @@
+/**
+ *
+ * Descripcion: Counters of each kind of operation, used by the counted
+ *              variant of the algorithms (see ob.h)
+ *
+ * Fichero: ob.c
+ * Autor: Ignacio Sánchez and Fabio Desio
+ * Version: 1.0
+ * Fecha: 18-10-2026
+ *
+ */
+
+#include <stdlib.h>
+#include <limits.h>
+#include "ob.h"
+
+/* Destino de las cuentas de cada hilo que no ha llamado a set_counters */
+OB_THREAD COUNTERS ob_discard;
+
+/* NULL: el hilo cuenta en su ob_discard */
+OB_THREAD PCOUNTERS ob_counters = NULL;
+
+/**
+ * Sets the struct where the counted algorithms of the calling thread 
+ * tally their operations
+ * @param pcounters pointer to the counters, NULL to stop counting
+ * @return Pointer to the counters used until now (NULL if none)
+ */
+PCOUNTERS set_counters(PCOUNTERS pcounters)
+{
+  PCOUNTERS previous = get_counters();
+
+  ob_counters = pcounters;
+
+  return previous;
+}
+
+/**
+ * Returns the struct where the counted algorithms of the calling thread
+ * tally their operations
+ * @return Pointer to the counters, NULL if none was set
+ */
+PCOUNTERS get_counters(void)
+{
+  return ob_counters;
+}
+
+/**
+ * Sets all the counters to 0
+ * @param pcounters pointer to the counters
+ */
+void reset_counters(PCOUNTERS pcounters)
+{
+  if (pcounters == NULL)
+    return;
+
+  pcounters->comparisons = 0;
+  pcounters->swaps = 0;
+  pcounters->moves = 0;
+  pcounters->allocations = 0;
+  pcounters->bytes = 0;
+}
+
+/**
+ * The algorithms count ob in a long. Converts that count for the int
+ * interface, saturating at INT_MAX instead of overflowing
+ * @param ob number of basic operations, or ERR
+ * @return ob, ERR or INT_MAX
+ */
+int narrow_ob(long ob)
+{
+  if (ob > INT_MAX)
+    return INT_MAX;
+
+  return (int)ob;
+}
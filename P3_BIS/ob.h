@@ -0,0 +1,78 @@
+/**
+ *
+ * Descripcion: Macros that count the basic operations (ob) of the
+ *              algorithms. sorting.c and search.c are compiled twice: 
+ *              normally, counting ob, and with -DNO_OB, where the macros 
+ *              disappear and every function gets the _nc suffix.
+ *              Besides ob, the counted variant tallies each kind of 
+ *              operation in the COUNTERS struct set with set_counters
+ *
+ * Fichero: ob.h
+ * Autor: Ignacio Sánchez and Fabio Desio
+ * Version: 1.2
+ * Fecha: 18-10-2026
+ *
+ */
+
+#ifndef OB_H
+#define OB_H
+
+#include "swap.h"
+
+/* type definitions */
+typedef struct counters {
+  long comparisons;  /* key comparisons */
+  long swaps;        /* swaps of two elements */
+  long moves;        /* elements written to a table */
+  long allocations;  /* calls to malloc/calloc */
+  long bytes;        /* bytes copied by moves and swaps */
+} COUNTERS, *PCOUNTERS;
+
+/* Each thread counts in its own COUNTERS struct */
+#if defined(__GNUC__)
+  #define OB_THREAD __thread
+#else
+  #define OB_THREAD
+#endif
+
+extern OB_THREAD PCOUNTERS ob_counters;
+extern OB_THREAD COUNTERS ob_discard;
+
+/* Counters of the calling thread, its own ob_discard until it calls
+ * set_counters */
+#define OB_COUNTERS (ob_counters != NULL ? ob_counters : &ob_discard)
+
+/* Functions */
+PCOUNTERS set_counters(PCOUNTERS pcounters);
+PCOUNTERS get_counters(void);
+void reset_counters(PCOUNTERS pcounters);
+int narrow_ob(long ob);
+
+#ifdef NO_OB
+  /* Uncounted variant: nothing is counted, OB(ob) is always true */
+  #define OB(ob) 1
+  #define OB_CHECK(ob) 1
+  #define OB_INC(ob) ((void)0)
+  #define OB_ADD(ob, n) ((void)0)
+  #define COUNT_CMP(n) ((void)0)
+  #define COUNT_MOVE(n) ((void)0)
+  #define COUNT_MOVE_WIDTH(n, width) ((void)0)
+  #define COUNT_ALLOC() ((void)0)
+  #define SWAP(p1, p2) swap(p1, p2)
+#else
+  /* Counted variant: OB(ob) counts one ob and one key comparison and is 
+   * true, to be used as OB(ob) && <key comparison>. OB_CHECK(ob) only
+   * counts the ob, for checks that do not compare keys */
+  #define OB(ob) (OB_COUNTERS->comparisons++, ++(ob))
+  #define OB_CHECK(ob) (++(ob))
+  #define OB_INC(ob) ((ob)++)
+  #define OB_ADD(ob, n) ((ob) += (n))
+  #define COUNT_CMP(n) (OB_COUNTERS->comparisons += (n))
+  #define COUNT_MOVE(n) (OB_COUNTERS->moves += (n), OB_COUNTERS->bytes += (n) * (long)sizeof(int))
+  /* Moves of keys narrowed to width bytes */
+  #define COUNT_MOVE_WIDTH(n, width) (OB_COUNTERS->moves += (n), OB_COUNTERS->bytes += (n) * (long)(width))
+  #define COUNT_ALLOC() (OB_COUNTERS->allocations++)
+  #define SWAP(p1, p2) (OB_COUNTERS->swaps++, OB_COUNTERS->bytes += 2 * (long)sizeof(int), swap(p1, p2))
+#endif
+
+#endif
@@ -11,6 +11,7 @@
 
 #include <stdlib.h>
 #include <stdio.h>
+#include <limits.h>
 #include "permutations.h"
 #include "swap.h"
 /***************************************************/
@@ -40,6 +41,30 @@ int random_num(int inf, int sup)
   return inf + (int)(((double)rand() * (sup - inf + 1.0) / (RAND_MAX + 1.0)));
 }
 
+/**
+ * 64-bit version of random_num. Ranges wider than RAND_MAX join two calls
+ * to rand(), the rest give the same numbers as random_num
+ * @param inf lower limit
+ * @param sup upper limit
+ * @return Random number between inf and sup
+ *         ERR in case of error
+ */
+long random_num64(long inf, long sup)
+{
+  double r;
+
+  if (inf < 0 || inf > sup)
+    return ERR;
+
+  if (sup - inf <= RAND_MAX)
+    return inf + (long)(((double)rand() * (sup - inf + 1.0) / (RAND_MAX + 1.0)));
+
+  /* Número aleatorio de 2 * log2(RAND_MAX + 1) bits en [0, 1) */
+  r = ((double)rand() * (RAND_MAX + 1.0) + rand()) / ((RAND_MAX + 1.0) * (RAND_MAX + 1.0));
+
+  return inf + (long)(r * (sup - inf + 1.0));
+}
+
 /***************************************************/
 /* Function: generate_perm Date:                   */
 /* Authors: Ignacio Sánchez and Fabio Desio        */
@@ -54,15 +79,27 @@ int random_num(int inf, int sup)
 /* or NULL in case of error                        */
 /***************************************************/
 int *generate_perm(int N)
+{
+  return generate_perm64(N);
+}
+
+/**
+ * 64-bit version of generate_perm. The elements are int, so N can be
+ * at most INT_MAX
+ * @param N number of elements in the permutation
+ * @return Pointer to the permutation
+ *         NULL in case of error
+ */
+int *generate_perm64(long N)
 {
   int *perm = NULL;
-  int i, random;
+  long i, random;
 
-  if (N < 1 || N > RAND_MAX)
+  if (N < 1 || N > INT_MAX)
     return NULL;
 
   /* Reservamos memoria para el array de manera dinámica */
-  perm = (int *)malloc(N * sizeof(perm[0]));
+  perm = (int *)malloc((size_t)N * sizeof(perm[0]));
 
   if (perm == NULL)
   {
@@ -71,12 +108,12 @@ int *generate_perm(int N)
 
   for (i = 0; i < N; i++)
   {
-    perm[i] = i + 1;
+    perm[i] = (int)(i + 1);
   }
 
   for (i = 0; i < N; i++)
   {
-    random = random_num(i, N - 1);
+    random = random_num64(i, N - 1);
     swap(&perm[i], &perm[random]);
   }
 
@@ -100,20 +137,32 @@ int *generate_perm(int N)
 /***************************************************/
 int **generate_permutations(int n_perms, int N)
 {
-  int i, j;
+  return generate_permutations64(n_perms, N);
+}
+
+/**
+ * 64-bit version of generate_permutations
+ * @param n_perms number of permutations
+ * @param N number of elements in each permutation (at most INT_MAX)
+ * @return Array of pointers to each of the permutations
+ *         NULL in case of error
+ */
+int **generate_permutations64(long n_perms, long N)
+{
+  long i, j;
   int **perms = NULL;
 
-  if (n_perms < 1 || n_perms > RAND_MAX || N < 1 || N > RAND_MAX)
+  if (n_perms < 1 || N < 1 || N > INT_MAX)
     return NULL;
 
-  perms = (int **)malloc(n_perms * sizeof(perms[0]));
+  perms = (int **)malloc((size_t)n_perms * sizeof(perms[0]));
 
   if (perms == NULL)
     return NULL;
 
   for (i = 0; i < n_perms; i++)
   {
-    perms[i] = generate_perm(N);
+    perms[i] = generate_perm64(N);
 
     if (perms[i] == NULL)
     {
@@ -142,7 +191,17 @@ int **generate_permutations(int n_perms, int N)
 /***************************************************/
 void free_permutations(int **perms, int n_perms)
 {
-  int i;
+  free_permutations64(perms, n_perms);
+}
+
+/**
+ * 64-bit version of free_permutations
+ * @param perms matrix of permutations
+ * @param n_perms number of permutations
+ */
+void free_permutations64(int **perms, long n_perms)
+{
+  long i;
 
   for (i = 0; i < n_perms; i++)
   {
@@ -150,4 +209,58 @@ void free_permutations(int **perms, int n_perms)
   }
 
   free(perms);
-}
\ No newline at end of file
+}
+
+/**
+ * Turns a random permutation of 1..N into one of the input shapes used to
+ * benchmark the sorting algorithms on patterned data
+ * @param perm random permutation of N elements
+ * @param N number of elements
+ * @param shape one of the SHAPE_* constants
+ * @return OK
+ *         ERR in case of error
+ */
+int shape_perm64(int *perm, long N, int shape)
+{
+  long i, prefix, random;
+
+  if (perm == NULL || N < 1 || N > INT_MAX)
+    return ERR;
+
+  switch (shape)
+  {
+  case SHAPE_RANDOM:
+    break;
+  case SHAPE_SORTED:
+    for (i = 0; i < N; i++)
+      perm[i] = (int)(i + 1);
+    break;
+  case SHAPE_REVERSED:
+    for (i = 0; i < N; i++)
+      perm[i] = (int)(N - i);
+    break;
+  case SHAPE_ORGAN_PIPE:
+    for (i = 0; i < N; i++)
+      perm[i] = (int)(i < (N + 1) / 2 ? i + 1 : N - i);
+    break;
+  case SHAPE_SORTED_PREFIX:
+    /* Prefijo ordenado y el resto de valores barajados al final */
+    prefix = N / 10 * 9;
+    for (i = 0; i < N; i++)
+      perm[i] = (int)(i + 1);
+    for (i = prefix; i < N; i++)
+    {
+      random = random_num64(i, N - 1);
+      swap(&perm[i], &perm[random]);
+    }
+    break;
+  case SHAPE_FEW_UNIQUE:
+    for (i = 0; i < N; i++)
+      perm[i] = 1 + perm[i] % SHAPE_UNIQUE_KEYS;
+    break;
+  default:
+    return ERR;
+  }
+
+  return OK;
+}
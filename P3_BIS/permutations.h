@@ -19,9 +19,25 @@
   #define OK (!(ERR))
 #endif
 
+/* input shapes given by shape_perm */
+#define SHAPE_RANDOM 0
+#define SHAPE_SORTED 1
+#define SHAPE_REVERSED 2
+#define SHAPE_ORGAN_PIPE 3    /* ascending up to the middle, then descending */
+#define SHAPE_SORTED_PREFIX 4 /* the first 9/10 sorted, the rest random */
+#define SHAPE_FEW_UNIQUE 5    /* values from 1 to SHAPE_UNIQUE_KEYS */
+#define SHAPE_UNIQUE_KEYS 16
+
 int random_num(int inf, int sup);
 int* generate_perm(int N);
 int** generate_permutations(int n_perms, int N);
 void free_permutations(int **perms, int n_perms);
 
+/* 64-bit versions: the functions above are thin wrappers over them */
+long random_num64(long inf, long sup);
+int* generate_perm64(long N);
+int** generate_permutations64(long n_perms, long N);
+void free_permutations64(int **perms, long n_perms);
+int shape_perm64(int *perm, long N, int shape);
+
 #endif
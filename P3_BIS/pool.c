@@ -0,0 +1,275 @@
+/**
+ *
+ * Descripcion: Implementation of a thread pool that runs a number of 
+ *              independent tasks and waits for all of them
+ *
+ * Fichero: pool.c
+ * Autor: Ignacio Sánchez and Fabio Desio
+ * Version: 1.0
+ * Fecha: 18-10-2026
+ *
+ */
+
+#define _POSIX_C_SOURCE 200112L
+
+#include <stdlib.h>
+#include <assert.h>
+#include <pthread.h>
+#include <unistd.h>
+#include "pool.h"
+
+struct pool {
+  int n_threads;          /* threads of the pool, including the caller */
+  pthread_t *threads;     /* worker threads (n_threads - 1) */
+  pthread_mutex_t lock;
+  pthread_cond_t work;    /* there is a new job or the pool must stop */
+  pthread_cond_t done;    /* the current job has finished */
+  pfunc_task task;        /* task of the current job */
+  void *arg;              /* argument of the current job */
+  int n_tasks;            /* number of tasks of the current job */
+  int next;               /* next task to hand out */
+  int finished;           /* number of tasks finished */
+  unsigned long job;      /* identifier of the current job */
+  int running;            /* 1 while a caller of pool_run owns the pool */
+  pthread_cond_t idle;    /* the pool can take a new job */
+  int stop;               /* 1 when the pool is being destroyed */
+};
+
+/* Pool compartido por todos los módulos, se crea una sola vez al primer uso */
+static PPOOL shared_pool = NULL;
+static pthread_once_t shared_once = PTHREAD_ONCE_INIT;
+
+/**
+ * Executes the pending tasks of the current job. Must be called with the
+ * lock held, which is released while each task runs
+ * @param ppool pointer to the pool
+ */
+static void run_tasks(PPOOL ppool)
+{
+  int t;
+
+  while (ppool->next < ppool->n_tasks)
+  {
+    t = ppool->next++;
+    pthread_mutex_unlock(&ppool->lock);
+
+    ppool->task(ppool->arg, t);
+
+    pthread_mutex_lock(&ppool->lock);
+    if (++ppool->finished == ppool->n_tasks)
+      pthread_cond_signal(&ppool->done);
+  }
+}
+
+/**
+ * Main loop of the worker threads: waits for a new job and takes 
+ * its tasks until the pool is destroyed
+ * @param arg pointer to the pool
+ * @return NULL
+ */
+static void *worker(void *arg)
+{
+  PPOOL ppool = (PPOOL)arg;
+  unsigned long seen;
+
+  pthread_mutex_lock(&ppool->lock);
+  seen = ppool->job;
+
+  while (1)
+  {
+    while (!ppool->stop && ppool->job == seen)
+      pthread_cond_wait(&ppool->work, &ppool->lock);
+
+    if (ppool->stop)
+      break;
+
+    seen = ppool->job;
+    run_tasks(ppool);
+  }
+
+  pthread_mutex_unlock(&ppool->lock);
+  return NULL;
+}
+
+/**
+ * Creates a pool of threads. The thread that calls pool_run also executes
+ * tasks, so n_threads - 1 worker threads are created
+ * @param n_threads number of threads, 0 or less to use all the online CPUs
+ * @return Pointer to the pool
+ *         NULL in case of error
+ */
+PPOOL init_pool(int n_threads)
+{
+  PPOOL ppool;
+  int i;
+
+  if (n_threads < 1)
+  {
+    n_threads = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    if (n_threads < 1)
+      n_threads = 1;
+  }
+
+  ppool = (PPOOL)malloc(sizeof(POOL));
+  if (ppool == NULL)
+    return NULL;
+
+  ppool->threads = (pthread_t *)malloc(n_threads * sizeof(ppool->threads[0]));
+  if (ppool->threads == NULL)
+  {
+    free(ppool);
+    return NULL;
+  }
+
+  pthread_mutex_init(&ppool->lock, NULL);
+  pthread_cond_init(&ppool->work, NULL);
+  pthread_cond_init(&ppool->done, NULL);
+  pthread_cond_init(&ppool->idle, NULL);
+  ppool->task = NULL;
+  ppool->arg = NULL;
+  ppool->n_tasks = ppool->next = ppool->finished = 0;
+  ppool->job = 0;
+  ppool->running = 0;
+  ppool->stop = 0;
+  ppool->n_threads = 1;
+
+  for (i = 0; i < n_threads - 1; i++)
+  {
+    if (pthread_create(&ppool->threads[i], NULL, worker, ppool) != 0)
+    {
+      free_pool(ppool);
+      return NULL;
+    }
+    ppool->n_threads++;
+  }
+
+  return ppool;
+}
+
+/**
+ * Stops the worker threads and frees the pool
+ * @param ppool pointer to the pool
+ */
+void free_pool(PPOOL ppool)
+{
+  int i;
+
+  if (ppool == NULL)
+    return;
+
+  pthread_mutex_lock(&ppool->lock);
+  ppool->stop = 1;
+  pthread_cond_broadcast(&ppool->work);
+  pthread_mutex_unlock(&ppool->lock);
+
+  for (i = 0; i < ppool->n_threads - 1; i++)
+    pthread_join(ppool->threads[i], NULL);
+
+  pthread_mutex_destroy(&ppool->lock);
+  pthread_cond_destroy(&ppool->work);
+  pthread_cond_destroy(&ppool->done);
+  pthread_cond_destroy(&ppool->idle);
+  free(ppool->threads);
+
+  if (ppool == shared_pool)
+    shared_pool = NULL;
+
+  free(ppool);
+}
+
+/**
+ * Returns the number of threads of the pool, including the caller
+ * @param ppool pointer to the pool
+ * @return Number of threads
+ */
+int pool_size(PPOOL ppool)
+{
+  assert(ppool != NULL);
+
+  return ppool->n_threads;
+}
+
+/**
+ * Runs task(arg, t) for t = 0..n_tasks-1 spread over the threads of the pool
+ * and returns when all of them have finished. The calling thread also runs
+ * tasks. Jobs of several threads on the same pool run one after another.
+ * Tasks must not call pool_run on the same pool
+ * @param ppool pointer to the pool
+ * @param n_tasks number of tasks
+ * @param task function executed for each task
+ * @param arg argument shared by all the tasks
+ * @return OK
+ *         ERR in case of error
+ */
+short pool_run(PPOOL ppool, int n_tasks, pfunc_task task, void *arg)
+{
+  int t;
+
+  if (ppool == NULL || task == NULL || n_tasks < 0)
+    return ERR;
+
+  /* Sin hilos auxiliares ejecutamos directamente */
+  if (ppool->n_threads == 1 || n_tasks == 1)
+  {
+    for (t = 0; t < n_tasks; t++)
+      task(arg, t);
+    return OK;
+  }
+
+  pthread_mutex_lock(&ppool->lock);
+
+  /* Si otro hilo está usando el pool esperamos a que termine */
+  while (ppool->running)
+    pthread_cond_wait(&ppool->idle, &ppool->lock);
+
+  ppool->running = 1;
+  ppool->task = task;
+  ppool->arg = arg;
+  ppool->n_tasks = n_tasks;
+  ppool->next = 0;
+  ppool->finished = 0;
+  ppool->job++;
+  pthread_cond_broadcast(&ppool->work);
+
+  run_tasks(ppool);
+
+  while (ppool->finished < ppool->n_tasks)
+    pthread_cond_wait(&ppool->done, &ppool->lock);
+
+  ppool->running = 0;
+  pthread_cond_signal(&ppool->idle);
+  pthread_mutex_unlock(&ppool->lock);
+
+  return OK;
+}
+
+/**
+ * Creates the shared pool, called once by pthread_once
+ */
+static void init_shared_pool(void)
+{
+  shared_pool = init_pool(0);
+}
+
+/**
+ * Returns the pool shared by the library, creating it with one thread
+ * per online CPU the first time it is requested, even by several threads
+ * at once
+ * @return Pointer to the pool
+ *         NULL in case of error or once free_default_pool has freed it
+ */
+PPOOL default_pool(void)
+{
+  pthread_once(&shared_once, init_shared_pool);
+
+  return shared_pool;
+}
+
+/**
+ * Stops the threads of the shared pool, if it was created, and frees it.
+ * Must be called once no other thread uses the library
+ */
+void free_default_pool(void)
+{
+  free_pool(shared_pool);
+}
@@ -0,0 +1,37 @@
+/**
+ *
+ * Descripcion: Header file for the thread pool
+ *
+ * Fichero: pool.h
+ * Autor: Ignacio Sánchez and Fabio Desio
+ * Version: 1.0
+ * Fecha: 18-10-2026
+ *
+ */
+
+#ifndef POOL_H
+#define POOL_H
+
+/* constants */
+
+#ifndef ERR
+  #define ERR -1
+  #define OK (!(ERR))
+#endif
+
+/* type definitions */
+
+/* Task executed by the pool: receives the shared argument and the task index */
+typedef void (* pfunc_task)(void*, int);
+
+typedef struct pool POOL, *PPOOL;
+
+/* Functions */
+PPOOL init_pool(int n_threads);
+void free_pool(PPOOL ppool);
+int pool_size(PPOOL ppool);
+short pool_run(PPOOL ppool, int n_tasks, pfunc_task task, void *arg);
+PPOOL default_pool(void);
+void free_default_pool(void);
+
+#endif
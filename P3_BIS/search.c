@@ -9,13 +9,91 @@
  *
  */
 
+#define _POSIX_C_SOURCE 200112L
+
 #include "search.h"
+#include "sorting.h"
 #include "swap.h"
+#include "simd.h"
+#include "pool.h"
+#include "ob.h"
 
 #include <stdlib.h>
+#include <string.h>
+#include <limits.h>
 #include <math.h>
 #include <assert.h>
 
+/* Lanes of an AVX2 register of ints */
+#define LANES 8
+
+typedef struct par_search {
+  int *table;           /* table to scan */
+  long F;               /* first position */
+  long L;               /* last position */
+  int key;              /* key to search */
+  volatile long best;   /* first position of the key found, LONG_MAX if none */
+  long ob;              /* elements compared by all the tasks */
+  PCOUNTERS counters;   /* counters of the calling thread, can be NULL */
+} PAR_SEARCH, *PPAR_SEARCH;
+
+typedef struct par_batch {
+  PDICT pdict;          /* dictionary, only read by the tasks */
+  const int *keys;      /* keys to search */
+  long n_keys;          /* number of keys */
+  long *positions;      /* position of each key */
+  long ob;              /* ob of all the tasks */
+  PCOUNTERS counters;   /* counters of the calling thread, can be NULL */
+} PAR_BATCH, *PPAR_BATCH;
+
+/**
+ * Computes the levels of the S-tree of n keys. The last level holds the 
+ * keys padded to nodes of STREE_B, and each node of a level above holds 
+ * the last key of STREE_B nodes of the level below. Levels are stored 
+ * from the root down
+ * @param n number of keys
+ * @param off array where the position of the first key of each level is
+ *        stored, the last element being the total size
+ * @return Number of levels
+ */
+static int stree_levels(long n, long *off)
+{
+  long nodes[STREE_MAX_HEIGHT];
+  int h, l;
+
+  /* Nodos de cada nivel, de las hojas a la raíz */
+  nodes[0] = (n + STREE_B - 1) / STREE_B;
+  for (h = 1; nodes[h - 1] > 1; h++)
+    nodes[h] = (nodes[h - 1] + STREE_B - 1) / STREE_B;
+
+  off[0] = 0;
+  for (l = 0; l < h; l++)
+    off[l + 1] = off[l] + nodes[h - 1 - l] * STREE_B;
+
+  return h;
+}
+
+/**
+ * Hash of a key for the HASHED dictionaries (finalizer of MurmurHash3)
+ * @param key key
+ * @return Hash of 32 bits: the low 7 go to the control byte, the rest 
+ *         choose the first group
+ */
+static unsigned int hash_mix(int key)
+{
+  unsigned int h = (unsigned int)key;
+
+  h ^= h >> 16;
+  h *= 0x85ebca6bU;
+  h ^= h >> 13;
+  h *= 0xc2b2ae35U;
+  h ^= h >> 16;
+
+  return h & 0xffffffffU;
+}
+
+/* La variante sin contar (-DNO_OB) sólo necesita las funciones de búsqueda */
+#ifndef NO_OB
 /**
  *  Key generation functions
  *
@@ -26,13 +104,13 @@
  */
 
 /**
- *  Function: uniform_key_generator
+ *  Function: uniform_key_generator64
  *               This function generates all keys from 1 to max in a sequential
  *               manner. If n_keys == max, each key will just be generated once.
  */
-void uniform_key_generator(int *keys, int n_keys, int max)
+void uniform_key_generator64(int *keys, long n_keys, int max)
 {
-  int i;
+  long i;
 
   for (i = 0; i < n_keys; i++)
     keys[i] = 1 + (i % max);
@@ -41,15 +119,24 @@ void uniform_key_generator(int *keys, int n_keys, int max)
 }
 
 /**
- *  Function: potential_key_generator
+ *  Function: uniform_key_generator
+ *               int interface of uniform_key_generator64
+ */
+void uniform_key_generator(int *keys, int n_keys, int max)
+{
+  uniform_key_generator64(keys, n_keys, max);
+}
+
+/**
+ *  Function: potential_key_generator64
  *               This function generates keys following an approximately
  *               potential distribution. The smaller values are much more
  *               likely than the bigger ones. Value 1 has a 50%
  *               probability, value 2 a 17%, value 3 the 9%, etc.
  */
-void potential_key_generator(int *keys, int n_keys, int max)
+void potential_key_generator64(int *keys, long n_keys, int max)
 {
-  int i;
+  long i;
 
   for (i = 0; i < n_keys; i++)
   {
@@ -59,7 +146,106 @@ void potential_key_generator(int *keys, int n_keys, int max)
   return;
 }
 
-PDICT init_dictionary(int size, char order)
+/**
+ *  Function: potential_key_generator
+ *               int interface of potential_key_generator64
+ */
+void potential_key_generator(int *keys, int n_keys, int max)
+{
+  potential_key_generator64(keys, n_keys, max);
+}
+
+/**
+ * Puts a key and its position in the first empty slot of its probe 
+ * sequence. The hash table must have room for it
+ * @param pdict pointer to a HASHED dictionary
+ * @param key key
+ * @param pos position of the key in the table
+ */
+static void hash_put(PDICT pdict, int key, long pos)
+{
+  unsigned int h;
+  long g, step, s;
+  int i;
+
+  h = hash_mix(key);
+  g = (long)(h >> 7) & (pdict->n_groups - 1);
+
+  /* Sondeo triangular por grupos: recorre todos si son potencia de 2 */
+  for (step = 1;; step++)
+  {
+    for (i = 0; i < HASH_GROUP; i++)
+    {
+      s = g * HASH_GROUP + i;
+      if (pdict->ctrl[s] == HASH_EMPTY)
+      {
+        pdict->ctrl[s] = (unsigned char)(h & 0x7f);
+        pdict->hkeys[s] = key;
+        pdict->hpos[s] = pos;
+        return;
+      }
+    }
+    g = (g + step) & (pdict->n_groups - 1);
+  }
+}
+
+/**
+ * Allocates the hash table of a HASHED dictionary with n_groups groups and
+ * inserts again the keys of the table
+ * @param pdict pointer to the dictionary
+ * @param n_groups number of groups, a power of 2
+ * @return OK
+ *         ERR in case of error
+ */
+static int hash_resize(PDICT pdict, long n_groups)
+{
+  unsigned char *ctrl = NULL;
+  int *hkeys = NULL;
+  long *hpos = NULL, i;
+
+  ctrl = (unsigned char *)malloc((size_t)n_groups * HASH_GROUP * sizeof(ctrl[0]));
+  hkeys = (int *)malloc((size_t)n_groups * HASH_GROUP * sizeof(hkeys[0]));
+  hpos = (long *)malloc((size_t)n_groups * HASH_GROUP * sizeof(hpos[0]));
+  if (ctrl == NULL || hkeys == NULL || hpos == NULL)
+  {
+    free(ctrl);
+    free(hkeys);
+    free(hpos);
+    return ERR;
+  }
+
+  free(pdict->ctrl);
+  free(pdict->hkeys);
+  free(pdict->hpos);
+
+  memset(ctrl, HASH_EMPTY, (size_t)n_groups * HASH_GROUP);
+  pdict->ctrl = ctrl;
+  pdict->hkeys = hkeys;
+  pdict->hpos = hpos;
+  pdict->n_groups = n_groups;
+
+  for (i = 0; i < pdict->n_data; i++)
+    hash_put(pdict, pdict->table[i], i);
+
+  return OK;
+}
+
+/**
+ * Number of groups of a hash table that holds n keys under HASH_LOAD
+ * @param n number of keys
+ * @return Power of 2
+ */
+static long hash_groups(long n)
+{
+  long g = 1;
+
+  while (g * HASH_GROUP * HASH_LOAD < n * 8)
+    g *= 2;
+
+  return g;
+}
+
+PDICT init_dictionary64(long size, char order)
 {
   PDICT pdict;
   /* Control de errores */
@@ -80,19 +266,77 @@ PDICT init_dictionary(int size, char order)
   pdict->size = size;
   pdict->n_data = 0;
   pdict->order = order;
+  pdict->eytz = NULL;
+  pdict->n_eytz = 0;
+  /* Los diccionarios ordenados usan el S-tree salvo que se desactive */
+  pdict->index = order == SORTED ? INDEX_STREE : INDEX_NONE;
+  pdict->stree = NULL;
+  pdict->n_stree = 0;
+  pdict->ctrl = NULL;
+  pdict->hkeys = NULL;
+  pdict->hpos = NULL;
+  pdict->n_groups = 0;
+  pdict->finger = 0;
+
+  if (order == HASHED && hash_resize(pdict, hash_groups(size)) == ERR)
+  {
+    free(pdict->table);
+    free(pdict);
+    return NULL;
+  }
 
   return pdict;
 }
 
+/**
+ * int interface of init_dictionary64
+ * @param size size of the dictionary
+ * @param order order of the dictionary
+ * @return Pointer to the dictionary
+ *         NULL in case of error
+ */
+PDICT init_dictionary(int size, char order)
+{
+  return init_dictionary64(size, order);
+}
+
 void free_dictionary(PDICT pdict)
 {
   free(pdict->table);
+  free(pdict->eytz);
+  free(pdict->stree);
+  free(pdict->ctrl);
+  free(pdict->hkeys);
+  free(pdict->hpos);
   free(pdict);
 }
 
+/**
+ * Sets the index used by search_dictionary on a sorted dictionary. SORTED
+ * dictionaries start with INDEX_STREE; INDEX_NONE turns it off
+ * @param pdict pointer to the dictionary
+ * @param index INDEX_NONE or INDEX_STREE
+ * @return OK
+ *         ERR in case of error
+ */
+int set_dictionary_index(PDICT pdict, char index)
+{
+  assert(pdict != NULL);
+
+  if (index != INDEX_NONE && index != INDEX_STREE)
+    return ERR;
+  if (index == INDEX_STREE && pdict->order != SORTED && pdict->order != EYTZINGER)
+    return ERR;
+
+  pdict->index = index;
+
+  return OK;
+}
+
 int insert_dictionary(PDICT pdict, int key)
 {
-  int ob = 0, i;
+  int ob = 0;
+  long i, size;
   int *tmp = NULL;
   /* Control de errores */
   assert(pdict != NULL);
@@ -100,15 +344,27 @@ int insert_dictionary(PDICT pdict, int key)
   /* Comprobamos si el diccionario está lleno */
   if (pdict->size == pdict->n_data)
   {
-    tmp = (int *)realloc(pdict->table, (int)((pdict->size * 1.1) + 1) * sizeof(int));
+    size = (long)(pdict->size * 1.1) + 1;
+    tmp = (int *)realloc(pdict->table, size * sizeof(int));
     if (tmp == NULL)
       return ERR;
 
     pdict->table = tmp;
+    pdict->size = size;
+  }
+
+  /* En la tabla hash, creciendo antes de pasar de la carga máxima */
+  if (pdict->order == HASHED)
+  {
+    if ((pdict->n_data + 1) * 8 > pdict->n_groups * HASH_GROUP * HASH_LOAD &&
+        hash_resize(pdict, 2 * pdict->n_groups) == ERR)
+      return ERR;
+
+    hash_put(pdict, key, pdict->n_data);
   }
 
   /* Si no está ordenado lo insertamos al final */
-  if (pdict->order == NOT_SORTED)
+  if (pdict->order == NOT_SORTED || pdict->order == HASHED)
   {
     pdict->table[pdict->n_data] = key;
     pdict->n_data++;
@@ -131,14 +387,53 @@ int insert_dictionary(PDICT pdict, int key)
   return ob;
 }
 
-int massive_insertion_dictionary(PDICT pdict, int *keys, int n_keys)
+/**
+ * Inserts n_keys keys in the dictionary. In a sorted dictionary they are
+ * appended, sorted and merged with the previous entries, instead of being
+ * inserted one by one in O(N) each
+ * @param pdict pointer to the dictionary
+ * @param keys keys to insert
+ * @param n_keys number of keys
+ * @return Number of basic operations of the insertions
+ *         ERR in case of error
+ */
+long massive_insertion_dictionary64(PDICT pdict, int *keys, long n_keys)
 {
-  int ob = 0, i, st;
+  long ob = 0, i, size, old;
+  int st;
+  int *tmp = NULL;
   /* Control de errores */
   assert(pdict != NULL);
   assert(keys != NULL);
   assert(n_keys > 0);
 
+  if (pdict->order == SORTED || pdict->order == EYTZINGER)
+  {
+    if (pdict->size < pdict->n_data + n_keys)
+    {
+      size = pdict->n_data + n_keys;
+      tmp = (int *)realloc(pdict->table, size * sizeof(int));
+      if (tmp == NULL)
+        return ERR;
+
+      pdict->table = tmp;
+      pdict->size = size;
+    }
+
+    old = pdict->n_data;
+    for (i = 0; i < n_keys; i++)
+      pdict->table[old + i] = keys[i];
+    pdict->n_data += n_keys;
+
+    /* Ordenamos las nuevas y las mezclamos con las que había */
+    if (n_keys > 1)
+      introsort64_nc(pdict->table, old, pdict->n_data - 1);
+    if (old > 0)
+      merge64_nc(pdict->table, 0, pdict->n_data - 1, old - 1);
+
+    return ob;
+  }
+
   /* No hace falta comprobar que el diccionario esté lleno pues se llama a la función insert_dictionary */
   for (i = 0; i < n_keys; i++)
   {
@@ -151,16 +446,230 @@ int massive_insertion_dictionary(PDICT pdict, int *keys, int n_keys)
   return ob;
 }
 
-int search_dictionary(PDICT pdict, int key, int *ppos, pfunc_search method)
+/**
+ * int interface of massive_insertion_dictionary64
+ * @param pdict pointer to the dictionary
+ * @param keys keys to insert
+ * @param n_keys number of keys
+ * @return Number of basic operations of the insertions, saturated at INT_MAX
+ *         ERR in case of error
+ */
+int massive_insertion_dictionary(PDICT pdict, int *keys, int n_keys)
+{
+  long ob;
+
+  ob = massive_insertion_dictionary64(pdict, keys, n_keys);
+  if (ob == ERR)
+    return ERR;
+
+  return narrow_ob(ob);
+}
+
+/**
+ * In-order traversal of the Eytzinger tree from node k, that takes the 
+ * sorted keys from position i on
+ * @param sorted sorted keys
+ * @param eytz Eytzinger table, node k in eytz[k]
+ * @param i position of the next sorted key
+ * @param k node
+ * @param n number of nodes
+ * @return Position of the next sorted key after the subtree of k
+ */
+static long eytzinger_fill(const int *sorted, int *eytz, long i, long k, long n)
+{
+  if (k <= n)
+  {
+    i = eytzinger_fill(sorted, eytz, i, 2 * k, n);
+    eytz[k] = sorted[i++];
+    i = eytzinger_fill(sorted, eytz, i, 2 * k + 1, n);
+  }
+
+  return i;
+}
+
+/**
+ * Builds the Eytzinger copy of the table of a dictionary if it does not
+ * hold all the entries. eytz[1] is the root, so the blocks of 
+ * EYTZ_PREFETCH descendants start at a multiple of EYTZ_ALIGN bytes
+ * @param pdict pointer to the dictionary
+ * @return OK
+ *         ERR in case of error
+ */
+static int eytzinger_layout(PDICT pdict)
+{
+  void *mem = NULL;
+
+  if (pdict->eytz != NULL && pdict->n_eytz == pdict->n_data)
+    return OK;
+
+  free(pdict->eytz);
+  pdict->eytz = NULL;
+  pdict->n_eytz = 0;
+
+  if (posix_memalign(&mem, EYTZ_ALIGN, (size_t)(pdict->n_data + 1) * sizeof(int)) != 0)
+    return ERR;
+
+  pdict->eytz = (int *)mem;
+  eytzinger_fill(pdict->table, pdict->eytz, 0, 1, pdict->n_data);
+  pdict->n_eytz = pdict->n_data;
+
+  return OK;
+}
+
+/**
+ * Returns the integer part of the base 2 logarithm
+ * @param x positive number
+ * @return floor(log2(x))
+ */
+static long floor_log2(long x)
+{
+#if defined(__GNUC__)
+  return (long)(sizeof(long) * CHAR_BIT - 1) - __builtin_clzl((unsigned long)x);
+#else
+  long l;
+
+  for (l = 0; (x >> l) > 1; l++)
+    ;
+
+  return l;
+#endif
+}
+
+/**
+ * Returns the position in the sorted table of the node of an Eytzinger 
+ * table of n entries. In the in-order traversal of the complete tree of 
+ * h + 1 levels, the internal nodes take the even positions and the m 
+ * nodes of the last level the first odd ones
+ * @param node index of the node, from 1 (the root) to n
+ * @param n number of entries
+ * @return Sorted rank of the node, from 0 to n - 1
+ */
+long eytzinger_rank(long node, long n)
+{
+  long h, d, p, m;
+
+  assert(node >= 1 && node <= n);
+
+  /* Último nivel del árbol y profundidad del nodo */
+  h = floor_log2(n);
+  d = floor_log2(node);
+
+  p = (2 * (node - (1L << d)) + 1) << (h - d);
+  m = n - ((1L << h) - 1);
+
+  return (p - 1) / 2 + (p / 2 < m ? p / 2 : m);
+}
+
+/**
+ * Builds the S-tree of the table of a dictionary if it does not hold all
+ * the entries. Nodes are aligned to EYTZ_ALIGN bytes, a cache line
+ * @param pdict pointer to the dictionary
+ * @return OK
+ *         ERR in case of error
+ */
+static int stree_layout(PDICT pdict)
+{
+  long off[STREE_MAX_HEIGHT + 1];
+  long i, child, below;
+  void *mem = NULL;
+  int h, l;
+
+  if (pdict->stree != NULL && pdict->n_stree == pdict->n_data)
+    return OK;
+
+  free(pdict->stree);
+  pdict->stree = NULL;
+  pdict->n_stree = 0;
+
+  h = stree_levels(pdict->n_data, off);
+  if (posix_memalign(&mem, EYTZ_ALIGN, (size_t)off[h] * sizeof(int)) != 0)
+    return ERR;
+
+  pdict->stree = (int *)mem;
+
+  /* Hojas: las claves rellenas con INT_MAX */
+  for (i = 0; i < off[h] - off[h - 1]; i++)
+    pdict->stree[off[h - 1] + i] = i < pdict->n_data ? pdict->table[i] : INT_MAX;
+
+  /* Cada clave de un nodo es la última del hijo correspondiente */
+  for (l = h - 2; l >= 0; l--)
+  {
+    below = (off[l + 2] - off[l + 1]) / STREE_B;
+    for (i = 0, child = 0; i < off[l + 1] - off[l]; i++, child++)
+      pdict->stree[off[l] + i] = child < below ? pdict->stree[off[l + 1] + child * STREE_B + STREE_B - 1] : INT_MAX;
+  }
+
+  pdict->n_stree = pdict->n_data;
+
+  return OK;
+}
+
+long search_dictionary64(PDICT pdict, int key, long *ppos, pfunc_search64 method)
 {
-  int ob = 0, st;
+  long ob = 0, st;
   /* Control de errores */
   assert(pdict != NULL);
   assert(ppos != NULL);
   assert(method != NULL);
 
-  st = method(pdict->table, 0, pdict->n_data, key, ppos);
-  if (st == NOT_FOUND)
+  /* Los diccionarios HASHED buscan en la tabla hash con cualquier método,
+   * que solo indica si se cuenta o no */
+  if (pdict->order == HASHED)
+  {
+    if (uncounted_search64(method) == method)
+      return hash_lookup64_nc(pdict, key, ppos);
+    return hash_lookup64(pdict, key, ppos);
+  }
+
+  /* La búsqueda de Eytzinger va sobre la copia con esa disposición */
+  if (method == eytzinger_search64 || method == eytzinger_search64_nc)
+  {
+    if (pdict->order != EYTZINGER || eytzinger_layout(pdict) == ERR)
+      return ERR;
+
+    st = method(pdict->eytz, 1, pdict->n_data, key, ppos);
+    if (st == ERR)
+      return ERR;
+
+    *ppos = eytzinger_rank(*ppos, pdict->n_data);
+    return st;
+  }
+
+  /* Con el índice S-tree las búsquedas binarias van por el árbol */
+  if (method == stree_search64 || method == stree_search64_nc ||
+      (pdict->index == INDEX_STREE &&
+       (method == bin_search64 || method == bin_search64_nc ||
+        method == branchless_search64 || method == branchless_search64_nc)))
+  {
+    if ((pdict->order != SORTED && pdict->order != EYTZINGER) || stree_layout(pdict) == ERR)
+      return ERR;
+
+    /* Contamos solo si la búsqueda pedida cuenta */
+    if (method == stree_search64_nc || method == bin_search64_nc || method == branchless_search64_nc)
+      method = stree_search64_nc;
+    else
+      method = stree_search64;
+
+    return method(pdict->stree, 0, pdict->n_data - 1, key, ppos);
+  }
+
+  /* La búsqueda por galope parte de la posición del último acierto */
+  if (method == gallop_search64 || method == gallop_search64_nc)
+  {
+    if (pdict->order != SORTED && pdict->order != EYTZINGER)
+      return ERR;
+
+    *ppos = pdict->finger < pdict->n_data ? pdict->finger : 0;
+    st = method(pdict->table, 0, pdict->n_data - 1, key, ppos);
+    if (st == ERR)
+      return ERR;
+
+    pdict->finger = *ppos;
+    return st;
+  }
+
+  st = method(pdict->table, 0, pdict->n_data - 1, key, ppos);
+  if (st == ERR)
     return ERR;
 
   ob += st;
@@ -168,10 +677,146 @@ int search_dictionary(PDICT pdict, int key, int *ppos, pfunc_search method)
   return ob;
 }
 
+/**
+ * int interface of search_dictionary64. Functions without a 64-bit
+ * version are called directly on the first INT_MAX entries
+ * @param pdict pointer to the dictionary
+ * @param key key to search
+ * @param ppos pointer where the position of the key is stored
+ * @param method search function
+ * @return Number of basic operations, saturated at INT_MAX
+ *         ERR in case of error
+ */
+int search_dictionary(PDICT pdict, int key, int *ppos, pfunc_search method)
+{
+  pfunc_search64 wide;
+  long pos, ob;
+  /* Control de errores */
+  assert(pdict != NULL);
+  assert(ppos != NULL);
+  assert(method != NULL);
+
+  wide = wide_search(method);
+  if (wide == NULL)
+    return method(pdict->table, 0, (int)(pdict->n_data < INT_MAX ? pdict->n_data - 1 : INT_MAX - 1), key, ppos);
+
+  ob = search_dictionary64(pdict, key, &pos, wide);
+  *ppos = (int)pos;
+
+  return narrow_ob(ob);
+}
+
+/**
+ * Returns the uncounted variant (_nc) of a search function, to be
+ * timed while the ob are taken from the counted one
+ * @param method counted search function
+ * @return Uncounted variant of method, or method itself if it has none
+ */
+pfunc_search uncounted_search(pfunc_search method)
+{
+  static const pfunc_search counted[] = {bin_search, lin_search, lin_auto_search, eytzinger_search,
+                                         branchless_search, simd_lin_search, par_lin_search,
+                                         stree_search, interp_search, interp_guarded_search,
+                                         gallop_search};
+  static const pfunc_search uncounted[] = {bin_search_nc, lin_search_nc, lin_auto_search_nc,
+                                           eytzinger_search_nc, branchless_search_nc,
+                                           simd_lin_search_nc, par_lin_search_nc, stree_search_nc,
+                                           interp_search_nc, interp_guarded_search_nc,
+                                           gallop_search_nc};
+  int i;
+
+  for (i = 0; i < (int)(sizeof(counted) / sizeof(counted[0])); i++)
+  {
+    if (counted[i] == method)
+      return uncounted[i];
+  }
+
+  return method;
+}
+
+/**
+ * Returns the uncounted variant (_nc) of a batch search function
+ * @param method counted batch search function
+ * @return Uncounted variant of method, or method itself if it has none
+ */
+pfunc_search_batch uncounted_search_batch(pfunc_search_batch method)
+{
+  if (method == search_dictionary_batch)
+    return search_dictionary_batch_nc;
+  if (method == simd_search_batch)
+    return simd_search_batch_nc;
+  if (method == par_search_batch)
+    return par_search_batch_nc;
+
+  return method;
+}
+
+/**
+ * Returns the uncounted variant (_nc) of a 64-bit search function
+ * @param method counted search function
+ * @return Uncounted variant of method, or method itself if it has none
+ */
+pfunc_search64 uncounted_search64(pfunc_search64 method)
+{
+  static const pfunc_search64 counted[] = {bin_search64, lin_search64, lin_auto_search64,
+                                           eytzinger_search64, branchless_search64,
+                                           simd_lin_search64, par_lin_search64, stree_search64,
+                                           interp_search64, interp_guarded_search64,
+                                           gallop_search64};
+  static const pfunc_search64 uncounted[] = {bin_search64_nc, lin_search64_nc, lin_auto_search64_nc,
+                                             eytzinger_search64_nc, branchless_search64_nc,
+                                             simd_lin_search64_nc, par_lin_search64_nc,
+                                             stree_search64_nc, interp_search64_nc,
+                                             interp_guarded_search64_nc, gallop_search64_nc};
+  int i;
+
+  for (i = 0; i < (int)(sizeof(counted) / sizeof(counted[0])); i++)
+  {
+    if (counted[i] == method)
+      return uncounted[i];
+  }
+
+  return method;
+}
+
+/**
+ * Returns the 64-bit version of a search function of the int interface,
+ * counted or uncounted
+ * @param method search function of the int interface
+ * @return 64-bit version of method, NULL if it has none
+ */
+pfunc_search64 wide_search(pfunc_search method)
+{
+  static const pfunc_search narrow[] = {
+      bin_search, lin_search, lin_auto_search, eytzinger_search, branchless_search,
+      simd_lin_search, par_lin_search, stree_search, interp_search, interp_guarded_search,
+      gallop_search,
+      bin_search_nc, lin_search_nc, lin_auto_search_nc, eytzinger_search_nc, branchless_search_nc,
+      simd_lin_search_nc, par_lin_search_nc, stree_search_nc, interp_search_nc,
+      interp_guarded_search_nc, gallop_search_nc};
+  static const pfunc_search64 wide[] = {
+      bin_search64, lin_search64, lin_auto_search64, eytzinger_search64, branchless_search64,
+      simd_lin_search64, par_lin_search64, stree_search64, interp_search64,
+      interp_guarded_search64, gallop_search64,
+      bin_search64_nc, lin_search64_nc, lin_auto_search64_nc, eytzinger_search64_nc,
+      branchless_search64_nc, simd_lin_search64_nc, par_lin_search64_nc, stree_search64_nc,
+      interp_search64_nc, interp_guarded_search64_nc, gallop_search64_nc};
+  int i;
+
+  for (i = 0; i < (int)(sizeof(narrow) / sizeof(narrow[0])); i++)
+  {
+    if (narrow[i] == method)
+      return wide[i];
+  }
+
+  return NULL;
+}
+#endif
+
 /* Search functions of the Dictionary ADT */
-int bin_search(int *table, int F, int L, int key, int *ppos)
+long bin_search64(int *table, long F, long L, int key, long *ppos)
 {
-  int M, ob = 0;
+  long M, ob = 0;
 
   /* Control de errores */
   assert(table != NULL);
@@ -180,13 +825,13 @@ int bin_search(int *table, int F, int L, int key, int *ppos)
 
   while (F <= L)
   {
-    M = (F + L) / 2;
-    if (++ob && table[M] == key)
+    M = F + (L - F) / 2;
+    if (OB(ob) && table[M] == key)
     {
       *ppos = M;
       return ob;
     }
-    else if (++ob && key < table[M])
+    else if (OB(ob) && key < table[M])
     {
       L = M - 1;
     }
@@ -200,9 +845,9 @@ int bin_search(int *table, int F, int L, int key, int *ppos)
   return ERR;
 }
 
-int lin_search(int *table, int F, int L, int key, int *ppos)
+long lin_search64(int *table, long F, long L, int key, long *ppos)
 {
-  int ob = 0;
+  long ob = 0;
 
   /* Control de errores */
   assert(table != NULL);
@@ -211,7 +856,7 @@ int lin_search(int *table, int F, int L, int key, int *ppos)
 
   for (; F <= L; F++)
   {
-    if (++ob && table[F] == key)
+    if (OB(ob) && table[F] == key)
     {
       *ppos = F;
       return ob;
@@ -222,9 +867,9 @@ int lin_search(int *table, int F, int L, int key, int *ppos)
   return ERR;
 }
 
-int lin_auto_search(int *table, int F, int L, int key, int *ppos)
+long lin_auto_search64(int *table, long F, long L, int key, long *ppos)
 {
-  int ob = 0, i;
+  long ob = 0, i;
 
   /* Control de errores */
   assert(table != NULL);
@@ -232,7 +877,7 @@ int lin_auto_search(int *table, int F, int L, int key, int *ppos)
   assert(ppos != NULL);
 
   /* Caso de encontrar la clave en la primera posición */
-  if (++ob && table[F] == key)
+  if (OB(ob) && table[F] == key)
   {
     *ppos = F;
     return ob;
@@ -241,15 +886,1095 @@ int lin_auto_search(int *table, int F, int L, int key, int *ppos)
   /* Caso general */
   for (i = 1; i <= L; i++)
   {
-    if (++ob && table[i] == key)
+    if (OB(ob) && table[i] == key)
     {
       *ppos = i;
       /* Intercambiamos con la posición anterior */
-      swap(&table[i], &table[i - 1]);
+      SWAP(&table[i], &table[i - 1]);
       return ob;
     }
   }
 
   *ppos = NOT_FOUND;
   return ERR;
-}
\ No newline at end of file
+}
+
+/**
+ * Search in a table in Eytzinger layout: table[F] is the root and the 
+ * children of the k-th node (from 1) are the 2k-th and (2k+1)-th. The 
+ * descent has no early exit, it ends in the leaves at the lower bound of
+ * key, and prefetches the block of descendants EYTZ_PREFETCH nodes ahead
+ * @param table table in Eytzinger layout
+ * @param F first position of the table
+ * @param L last position of the table
+ * @param key key to search
+ * @param ppos pointer where the position of the key is stored
+ * @return Number of basic operations
+ *         ERR if the key is not in the table
+ */
+long eytzinger_search64(int *table, long F, long L, int key, long *ppos)
+{
+  long k, n, ob = 0;
+
+  /* Control de errores */
+  assert(table != NULL);
+  assert(F <= L);
+  assert(ppos != NULL);
+
+  n = L - F + 1;
+
+  /* El nodo k está en table[F - 1 + k] */
+  for (k = 1; k <= n;)
+  {
+    if (k * EYTZ_PREFETCH <= n)
+      PREFETCH(&table[F - 1 + k * EYTZ_PREFETCH]);
+    k = 2 * k + (OB(ob) && table[F - 1 + k] < key);
+  }
+
+  /* Deshacemos los giros a la derecha tras el último a la izquierda */
+  while (k & 1)
+    k >>= 1;
+  k >>= 1;
+
+  if (k > 0 && OB(ob) && table[F - 1 + k] == key)
+  {
+    *ppos = F - 1 + k;
+    return ob;
+  }
+
+  *ppos = NOT_FOUND;
+  return ERR;
+}
+
+/**
+ * Branchless binary search for the lower bound of key. Each step halves
+ * the interval with a conditional move instead of the two branches of 
+ * bin_search, and prefetches the two possible next midpoints. The equality
+ * is only checked once at the end. The counted variant reports one key 
+ * comparison per step
+ * @param table sorted table
+ * @param F first position of the table
+ * @param L last position of the table
+ * @param key key to search
+ * @param ppos pointer where the position of the key is stored
+ * @return Number of basic operations
+ *         ERR if the key is not in the table
+ */
+long branchless_search64(int *table, long F, long L, int key, long *ppos)
+{
+  long base, half, n, ob = 0;
+
+  /* Control de errores */
+  assert(table != NULL);
+  assert(F <= L);
+  assert(ppos != NULL);
+
+  /* La cota inferior está siempre en [base, base + n] */
+  for (base = F, n = L - F + 1; n > 1; n -= half)
+  {
+    half = n / 2;
+    PREFETCH(&table[base + (n - half) / 2]);
+    PREFETCH(&table[base + half + (n - half) / 2]);
+    base += half * (OB(ob) && table[base + half] < key);
+  }
+
+  base += (OB(ob) && table[base] < key);
+
+  if (base <= L && OB(ob) && table[base] == key)
+  {
+    *ppos = base;
+    return ob;
+  }
+
+  *ppos = NOT_FOUND;
+  return ERR;
+}
+
+#if SIMD_AVX2
+/**
+ * Scans table[F..L] for key 2 * LANES elements at a time: the comparisons
+ * of both registers are joined in one movemask, whose lowest bit gives 
+ * the first match
+ * @param table table to scan
+ * @param F first position
+ * @param L last position
+ * @param key key to search
+ * @return First position of the key
+ *         NOT_FOUND if it is not in the table
+ */
+TARGET_AVX2 static long scan_avx2(const int *table, long F, long L, int key)
+{
+  __m256i k, a, b;
+  int mask;
+
+  k = _mm256_set1_epi32(key);
+  for (; F + 2 * LANES - 1 <= L; F += 2 * LANES)
+  {
+    a = _mm256_cmpeq_epi32(_mm256_loadu_si256((const __m256i *)&table[F]), k);
+    b = _mm256_cmpeq_epi32(_mm256_loadu_si256((const __m256i *)&table[F + LANES]), k);
+    mask = _mm256_movemask_ps(_mm256_castsi256_ps(a)) | _mm256_movemask_ps(_mm256_castsi256_ps(b)) << LANES;
+    if (mask != 0)
+      return F + __builtin_ctz(mask);
+  }
+
+  for (; F <= L; F++)
+  {
+    if (table[F] == key)
+      return F;
+  }
+
+  return NOT_FOUND;
+}
+#endif
+
+/**
+ * Scans table[F..L] for key, with AVX2 if the CPU has it
+ * @param table table to scan
+ * @param F first position
+ * @param L last position
+ * @param key key to search
+ * @return First position of the key
+ *         NOT_FOUND if it is not in the table
+ */
+static long scan(const int *table, long F, long L, int key)
+{
+#if SIMD_AVX2
+  if (CPU_HAS_AVX2())
+    return scan_avx2(table, F, L, key);
+#endif
+
+  for (; F <= L; F++)
+  {
+    if (table[F] == key)
+      return F;
+  }
+
+  return NOT_FOUND;
+}
+
+/**
+ * Linear search that compares 2 * LANES keys per step with AVX2 (one key
+ * per step on other CPUs). The ob are the elements compared, as in 
+ * lin_search
+ * @param table table
+ * @param F first position of the table
+ * @param L last position of the table
+ * @param key key to search
+ * @param ppos pointer where the position of the key is stored
+ * @return Number of basic operations
+ *         ERR if the key is not in the table
+ */
+long simd_lin_search64(int *table, long F, long L, int key, long *ppos)
+{
+  long pos, ob = 0;
+
+  /* Control de errores */
+  assert(table != NULL);
+  assert(F <= L);
+  assert(ppos != NULL);
+
+  pos = scan(table, F, L, key);
+
+  OB_ADD(ob, pos == NOT_FOUND ? L - F + 1 : pos - F + 1);
+  COUNT_CMP(pos == NOT_FOUND ? L - F + 1 : pos - F + 1);
+
+  *ppos = pos;
+  if (pos == NOT_FOUND)
+    return ERR;
+
+  return ob;
+}
+
+/**
+ * Task of the pool of par_lin_search: scans block t of the table in steps
+ * of PAR_SEARCH_STEP, stopping as soon as the key has been found before
+ * the current step
+ * @param arg pointer to the search
+ * @param t index of the block
+ */
+static void par_search_task(void *arg, int t)
+{
+  PPAR_SEARCH ps = (PPAR_SEARCH)arg;
+  long i, first, last, end, pos, best, n = 0, ob = 0;
+  COUNTERS cuentas;
+  PCOUNTERS previas;
+
+  first = ps->F + t * PAR_SEARCH_BLOCK;
+  last = first + PAR_SEARCH_BLOCK - 1 < ps->L ? first + PAR_SEARCH_BLOCK - 1 : ps->L;
+
+  reset_counters(&cuentas);
+  previas = set_counters(&cuentas);
+
+  for (i = first; i <= last && i < ps->best; i = end + 1)
+  {
+    end = i + PAR_SEARCH_STEP - 1 < last ? i + PAR_SEARCH_STEP - 1 : last;
+    pos = scan(ps->table, i, end, ps->key);
+    n += pos == NOT_FOUND ? end - i + 1 : pos - i + 1;
+    if (pos != NOT_FOUND)
+    {
+      /* Nos quedamos con la primera aparición */
+      do
+        best = ps->best;
+      while (pos < best && !__sync_bool_compare_and_swap(&ps->best, best, pos));
+      break;
+    }
+  }
+
+  OB_ADD(ob, n);
+  COUNT_CMP(n);
+  set_counters(previas);
+
+  __sync_fetch_and_add(&ps->ob, ob);
+  if (ps->counters != NULL)
+    __sync_fetch_and_add(&ps->counters->comparisons, cuentas.comparisons);
+}
+
+/**
+ * Linear search for huge unsorted tables: the table is split in blocks of
+ * PAR_SEARCH_BLOCK that the threads of the shared pool scan with 
+ * simd_lin_search in ascending order. The blocks after the first hit are
+ * skipped and the ones in progress stop at their next step, so the ob 
+ * (elements compared) depend on the scheduling. Tables of less than 
+ * PAR_SEARCH_MIN elements are scanned by the calling thread. It must not
+ * be called from a task of the pool
+ * @param table table
+ * @param F first position of the table
+ * @param L last position of the table
+ * @param key key to search
+ * @param ppos pointer where the position of the key is stored
+ * @return Number of basic operations
+ *         ERR if the key is not in the table or in case of error
+ */
+long par_lin_search64(int *table, long F, long L, int key, long *ppos)
+{
+  PAR_SEARCH ps;
+  PPOOL ppool = NULL;
+  long n_blocks;
+
+  /* Control de errores */
+  assert(table != NULL);
+  assert(F <= L);
+  assert(ppos != NULL);
+
+  n_blocks = (L - F + PAR_SEARCH_BLOCK) / PAR_SEARCH_BLOCK;
+  if (L - F + 1 >= PAR_SEARCH_MIN && n_blocks <= INT_MAX)
+    ppool = default_pool();
+
+  if (ppool == NULL || pool_size(ppool) == 1)
+    return simd_lin_search64(table, F, L, key, ppos);
+
+  ps.table = table;
+  ps.F = F;
+  ps.L = L;
+  ps.key = key;
+  ps.best = LONG_MAX;
+  ps.ob = 0;
+  ps.counters = get_counters();
+
+  if (pool_run(ppool, (int)n_blocks, par_search_task, &ps) == ERR)
+  {
+    *ppos = NOT_FOUND;
+    return ERR;
+  }
+
+  if (ps.best == LONG_MAX)
+  {
+    *ppos = NOT_FOUND;
+    return ERR;
+  }
+
+  *ppos = ps.best;
+
+  return ps.ob;
+}
+
+#if SIMD_AVX2
+/**
+ * Number of keys of an S-tree node smaller than key, with two AVX2 
+ * compares and a movemask
+ * @param node node of STREE_B sorted keys
+ * @param key key to search
+ * @return Position of the lower bound of key in the node
+ */
+TARGET_AVX2 static int node_rank_avx2(const int *node, int key)
+{
+  __m256i k;
+  int mask;
+
+  k = _mm256_set1_epi32(key);
+  mask = _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpgt_epi32(k, _mm256_loadu_si256((const __m256i *)node)))) |
+         _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpgt_epi32(k, _mm256_loadu_si256((const __m256i *)(node + LANES))))) << LANES;
+
+  return __builtin_popcount(mask);
+}
+#endif
+
+/**
+ * Number of keys of an S-tree node smaller than key
+ * @param node node of STREE_B sorted keys
+ * @param key key to search
+ * @return Position of the lower bound of key in the node
+ */
+static int node_rank(const int *node, int key)
+{
+  int i, c = 0;
+
+#if SIMD_AVX2
+  if (CPU_HAS_AVX2())
+    return node_rank_avx2(node, key);
+#endif
+
+  for (i = 0; i < STREE_B; i++)
+    c += node[i] < key;
+
+  return c;
+}
+
+/**
+ * Search in a static S-tree of the keys of a sorted table, as built by 
+ * search_dictionary: each level is one node of STREE_B keys, compared at
+ * once, so a search touches about log16(N) cache lines. The last level
+ * holds the keys in order, so the position found is their sorted rank.
+ * The ob count the STREE_B keys of each node
+ * @param table S-tree, whose levels only depend on the number of keys
+ * @param F first position of the keys
+ * @param L last position of the keys
+ * @param key key to search
+ * @param ppos pointer where the position of the key is stored
+ * @return Number of basic operations
+ *         ERR if the key is not in the table
+ */
+long stree_search64(int *table, long F, long L, int key, long *ppos)
+{
+  long off[STREE_MAX_HEIGHT + 1];
+  long k, ob = 0;
+  int h, l, c;
+
+  /* Control de errores */
+  assert(table != NULL);
+  assert(F <= L);
+  assert(ppos != NULL);
+
+  h = stree_levels(L - F + 1, off);
+
+  /* k es el nodo de cada nivel y al final la posición en las hojas */
+  for (l = 0, k = 0; l < h; l++)
+  {
+    c = node_rank(&table[F + off[l] + k * STREE_B], key);
+    OB_ADD(ob, STREE_B);
+    COUNT_CMP(STREE_B);
+    if (c == STREE_B)
+      break;
+    k = k * STREE_B + c;
+  }
+
+  if (l == h && k <= L - F && OB(ob) && table[F + off[h - 1] + k] == key)
+  {
+    *ppos = F + k;
+    return ob;
+  }
+
+  *ppos = NOT_FOUND;
+  return ERR;
+}
+
+/**
+ * Position of key in table[F..L] estimated by linear interpolation 
+ * between table[F] and table[L]
+ * @param table sorted table
+ * @param F first position, with table[F] <= key
+ * @param L last position, with key <= table[L]
+ * @param key key to search
+ * @return Estimated position, between F and L
+ */
+static long interp_pos(const int *table, long F, long L, int key)
+{
+  if (table[L] == table[F])
+    return F;
+
+  /* En double para que las restas de claves no desborden */
+  return F + (long)(((double)key - table[F]) / ((double)table[L] - table[F]) * (L - F));
+}
+
+/**
+ * Interpolation search: each probe is at the position that key would
+ * have if the keys of the interval grew linearly. On uniformly 
+ * distributed keys it takes O(log log N) probes, but O(N) on skewed ones
+ * @param table sorted table
+ * @param F first position of the table
+ * @param L last position of the table
+ * @param key key to search
+ * @param ppos pointer where the position of the key is stored
+ * @return Number of basic operations
+ *         ERR if the key is not in the table
+ */
+long interp_search64(int *table, long F, long L, int key, long *ppos)
+{
+  long M, ob = 0;
+
+  /* Control de errores */
+  assert(table != NULL);
+  assert(F <= L);
+  assert(ppos != NULL);
+
+  while (F <= L && OB(ob) && table[F] <= key && OB(ob) && key <= table[L])
+  {
+    M = interp_pos(table, F, L, key);
+    if (OB(ob) && table[M] == key)
+    {
+      *ppos = M;
+      return ob;
+    }
+    else if (OB(ob) && table[M] < key)
+    {
+      F = M + 1;
+    }
+    else
+    {
+      L = M - 1;
+    }
+  }
+
+  *ppos = NOT_FOUND;
+  return ERR;
+}
+
+/**
+ * Guarded interpolation search: after an interpolation probe that does 
+ * not halve the interval, the next probe is a binary one, so it never 
+ * takes more than about twice the probes of bin_search. Intervals of 
+ * INTERP_SEQUENTIAL elements or less are scanned sequentially
+ * @param table sorted table
+ * @param F first position of the table
+ * @param L last position of the table
+ * @param key key to search
+ * @param ppos pointer where the position of the key is stored
+ * @return Number of basic operations
+ *         ERR if the key is not in the table
+ */
+long interp_guarded_search64(int *table, long F, long L, int key, long *ppos)
+{
+  long M, n, ob = 0;
+  int binary = 0;
+
+  /* Control de errores */
+  assert(table != NULL);
+  assert(F <= L);
+  assert(ppos != NULL);
+
+  while (L - F + 1 > INTERP_SEQUENTIAL && OB(ob) && table[F] <= key && OB(ob) && key <= table[L])
+  {
+    n = L - F + 1;
+    M = binary ? F + (L - F) / 2 : interp_pos(table, F, L, key);
+
+    if (OB(ob) && table[M] == key)
+    {
+      *ppos = M;
+      return ob;
+    }
+    else if (OB(ob) && table[M] < key)
+    {
+      F = M + 1;
+    }
+    else
+    {
+      L = M - 1;
+    }
+
+    /* Estimación mala: el siguiente paso es binario */
+    binary = !binary && 2 * (L - F + 1) > n;
+  }
+
+  /* Si sale por el rango, key no puede estar en el intervalo */
+  if (L - F + 1 > INTERP_SEQUENTIAL)
+  {
+    *ppos = NOT_FOUND;
+    return ERR;
+  }
+
+  /* Tabla ordenada: se para en el primer elemento >= key */
+  for (; F <= L; F++)
+  {
+    if (OB(ob) && table[F] >= key)
+    {
+      if (table[F] == key)
+      {
+        *ppos = F;
+        return ob;
+      }
+      break;
+    }
+  }
+
+  *ppos = NOT_FOUND;
+  return ERR;
+}
+
+/**
+ * Finger search: gallops from the position *ppos towards key with steps 
+ * 1, 2, 4, ... and ends with a binary search between the last two probes,
+ * so it takes O(log d) probes, d being the distance from *ppos to key. 
+ * search_dictionary keeps the last hit of the dictionary in *ppos
+ * @param table sorted table
+ * @param F first position of the table
+ * @param L last position of the table
+ * @param key key to search
+ * @param ppos pointer to the starting position (F if it is out of 
+ *             [F, L]), where the position of the key is stored
+ * @return Number of basic operations
+ *         ERR if the key is not in the table
+ */
+long gallop_search64(int *table, long F, long L, int key, long *ppos)
+{
+  long f, lo, hi, M, step, ob = 0;
+
+  /* Control de errores */
+  assert(table != NULL);
+  assert(F <= L);
+  assert(ppos != NULL);
+
+  f = (*ppos >= F && *ppos <= L) ? *ppos : F;
+
+  /* Galope hasta dejar key en (lo, hi]; F - 1 y L + 1 hacen de centinelas */
+  step = 1;
+  if (OB(ob) && table[f] < key)
+  {
+    lo = f;
+    while (step <= L - f && OB(ob) && table[f + step] < key)
+    {
+      lo = f + step;
+      step *= 2;
+    }
+    hi = step <= L - f ? f + step : L + 1;
+  }
+  else
+  {
+    hi = f;
+    while (step <= f - F && OB(ob) && table[f - step] >= key)
+    {
+      hi = f - step;
+      step *= 2;
+    }
+    lo = step <= f - F ? f - step : F - 1;
+  }
+
+  /* Primer elemento >= key */
+  while (hi - lo > 1)
+  {
+    M = lo + (hi - lo) / 2;
+    if (OB(ob) && table[M] < key)
+      lo = M;
+    else
+      hi = M;
+  }
+
+  if (hi <= L && OB(ob) && table[hi] == key)
+  {
+    *ppos = hi;
+    return ob;
+  }
+
+  *ppos = NOT_FOUND;
+  return ERR;
+}
+
+#if SIMD_SSE2
+/**
+ * Compares the HASH_GROUP control bytes of a group with h2 and with 
+ * HASH_EMPTY, one SSE2 compare and movemask each
+ * @param ctrl control bytes of the group
+ * @param h2 low 7 bits of the hash of the key
+ * @param empty pointer where the mask of the empty slots is stored
+ * @return Mask of the slots whose control byte is h2
+ */
+TARGET_SSE2 static int group_match_sse2(const unsigned char *ctrl, unsigned char h2, int *empty)
+{
+  __m128i g;
+
+  g = _mm_loadu_si128((const __m128i *)ctrl);
+  *empty = _mm_movemask_epi8(_mm_cmpeq_epi8(g, _mm_set1_epi8((char)HASH_EMPTY)));
+
+  return _mm_movemask_epi8(_mm_cmpeq_epi8(g, _mm_set1_epi8((char)h2)));
+}
+#endif
+
+/**
+ * Compares the HASH_GROUP control bytes of a group with h2 and with 
+ * HASH_EMPTY, with SSE2 if the CPU has it
+ * @param ctrl control bytes of the group
+ * @param h2 low 7 bits of the hash of the key
+ * @param empty pointer where the mask of the empty slots is stored
+ * @return Mask of the slots whose control byte is h2
+ */
+static int group_match(const unsigned char *ctrl, unsigned char h2, int *empty)
+{
+  int i, match = 0;
+
+#if SIMD_SSE2
+  if (CPU_HAS_SSE2())
+    return group_match_sse2(ctrl, h2, empty);
+#endif
+
+  *empty = 0;
+  for (i = 0; i < HASH_GROUP; i++)
+  {
+    match |= (ctrl[i] == h2) << i;
+    *empty |= (ctrl[i] == HASH_EMPTY) << i;
+  }
+
+  return match;
+}
+
+/**
+ * Lookup in the hash table of a HASHED dictionary. The groups of the probe
+ * sequence are compared HASH_GROUP control bytes at a time, only the slots
+ * whose control byte matches have their key compared, and the search ends
+ * at the first group with an empty slot. The ob are one per group plus 
+ * the keys compared
+ * @param pdict pointer to the dictionary
+ * @param key key to search
+ * @param ppos pointer where the position of the key in the table is stored
+ * @return Number of basic operations
+ *         ERR if the key is not in the dictionary
+ */
+long hash_lookup64(PDICT pdict, int key, long *ppos)
+{
+  unsigned int h;
+  unsigned char h2;
+  long g, step, ob = 0;
+  int i, match, empty;
+
+  /* Control de errores */
+  assert(pdict != NULL);
+  assert(pdict->order == HASHED);
+  assert(ppos != NULL);
+
+  h = hash_mix(key);
+  h2 = (unsigned char)(h & 0x7f);
+  g = (long)(h >> 7) & (pdict->n_groups - 1);
+
+  for (step = 1; step <= pdict->n_groups; step++)
+  {
+    OB_INC(ob);
+    match = group_match(&pdict->ctrl[g * HASH_GROUP], h2, &empty);
+
+    for (i = 0; match != 0; i++, match >>= 1)
+    {
+      if ((match & 1) && OB(ob) && pdict->hkeys[g * HASH_GROUP + i] == key)
+      {
+        *ppos = pdict->hpos[g * HASH_GROUP + i];
+        return ob;
+      }
+    }
+
+    /* Un hueco libre corta la secuencia de sondeo */
+    if (empty != 0)
+      break;
+
+    g = (g + step) & (pdict->n_groups - 1);
+  }
+
+  *ppos = NOT_FOUND;
+  return ERR;
+}
+
+/**
+ * Lower bounds of n_keys keys in table[0..n-1], BATCH_SEARCH_LANES at a
+ * time: every lane is the state of one binary search, and each round 
+ * does one step of every lane and prefetches its next probe, so the cache
+ * misses of the lanes overlap instead of stalling one after another. A
+ * lane that ends takes the next key
+ * @param table sorted table
+ * @param n number of entries of the table
+ * @param keys keys to search
+ * @param n_keys number of keys
+ * @param positions where the position of each key, or NOT_FOUND, is stored
+ * @return Number of basic operations
+ */
+static long interleaved_search(const int *table, long n, const int *keys, long n_keys,
+                               long *positions)
+{
+  long base[BATCH_SEARCH_LANES], len[BATCH_SEARCH_LANES], idx[BATCH_SEARCH_LANES];
+  long next = 0, active = 0, half, ob = 0;
+  int j, key;
+
+  PREFETCH(&table[n / 2]);
+  for (j = 0; j < BATCH_SEARCH_LANES; j++)
+  {
+    base[j] = 0;
+    len[j] = n;
+    idx[j] = next < n_keys ? next++ : -1;
+    if (idx[j] >= 0)
+      active++;
+  }
+
+  while (active > 0)
+  {
+    for (j = 0; j < BATCH_SEARCH_LANES; j++)
+    {
+      if (idx[j] < 0)
+        continue;
+
+      key = keys[idx[j]];
+      if (len[j] > 1)
+      {
+        half = len[j] / 2;
+        base[j] += half * (OB(ob) && table[base[j] + half] < key);
+        len[j] -= half;
+      }
+      else
+      {
+        /* Último paso: cota inferior y comprobación de la clave */
+        base[j] += (OB(ob) && table[base[j]] < key);
+        if (base[j] < n && OB(ob) && table[base[j]] == key)
+          positions[idx[j]] = base[j];
+        else
+          positions[idx[j]] = NOT_FOUND;
+
+        base[j] = 0;
+        len[j] = n;
+        if (next == n_keys)
+        {
+          idx[j] = -1;
+          active--;
+          continue;
+        }
+        idx[j] = next++;
+      }
+
+      PREFETCH(&table[base[j] + len[j] / 2]);
+    }
+  }
+
+  return ob;
+}
+
+#if SIMD_AVX2
+/**
+ * Lower bounds of the first n_keys - n_keys % LANES keys in table[0..n-1],
+ * LANES keys per iteration: the LANES binary searches advance together, 
+ * with a gather of their probes and a compare mask that moves the base of
+ * the lanes whose probe is smaller than their key. The indices of the
+ * gather are int, so n must be at most INT_MAX
+ * @param table sorted table
+ * @param n number of entries of the table
+ * @param keys keys to search
+ * @param n_keys number of keys
+ * @param positions where the position of each key, or NOT_FOUND, is stored
+ * @return Number of basic operations
+ */
+TARGET_AVX2 static long gather_search_avx2(const int *table, long n, const int *keys,
+                                           long n_keys, long *positions)
+{
+  __m256i k, base, v, h;
+  int lb[LANES];
+  long i, len, half, steps = 0, ob = 0;
+  int j;
+
+  for (i = 0; i + LANES <= n_keys; i += LANES)
+  {
+    k = _mm256_loadu_si256((const __m256i *)&keys[i]);
+    base = _mm256_setzero_si256();
+    for (len = n, steps = 0; len > 1; len -= half, steps++)
+    {
+      half = len / 2;
+      h = _mm256_set1_epi32((int)half);
+      v = _mm256_i32gather_epi32(table, _mm256_add_epi32(base, h), 4);
+      base = _mm256_add_epi32(base, _mm256_and_si256(_mm256_cmpgt_epi32(k, v), h));
+    }
+
+    /* Último paso: la máscara vale -1 donde table[base] < key */
+    v = _mm256_i32gather_epi32(table, base, 4);
+    base = _mm256_sub_epi32(base, _mm256_cmpgt_epi32(k, v));
+    _mm256_storeu_si256((__m256i *)lb, base);
+
+    for (j = 0; j < LANES; j++)
+    {
+      if (lb[j] < n && OB(ob) && table[lb[j]] == keys[i + j])
+        positions[i + j] = lb[j];
+      else
+        positions[i + j] = NOT_FOUND;
+    }
+  }
+
+  /* Cada clave hace steps + 1 comparaciones en los vectores */
+  OB_ADD(ob, (i / LANES) * LANES * (steps + 1));
+  COUNT_CMP((i / LANES) * LANES * (steps + 1));
+
+  return ob;
+}
+#endif
+
+/**
+ * Searches n_keys keys at once. On sorted dictionaries the binary searches
+ * are interleaved (see interleaved_search), which hides the cache misses
+ * of tables bigger than the cache; HASHED and NOT_SORTED dictionaries 
+ * search the keys one by one with hash_lookup64 and lin_search64
+ * @param pdict pointer to the dictionary
+ * @param keys keys to search
+ * @param n_keys number of keys
+ * @param positions where the position of each key, or NOT_FOUND, is stored
+ * @return Number of basic operations (of the keys found, out of the
+ *         sorted dictionaries)
+ */
+long search_dictionary_batch(PDICT pdict, const int *keys, long n_keys, long *positions)
+{
+  long i, st, ob = 0;
+
+  /* Control de errores */
+  assert(pdict != NULL);
+  assert(keys != NULL || n_keys == 0);
+  assert(positions != NULL || n_keys == 0);
+
+  if (pdict->n_data == 0)
+  {
+    for (i = 0; i < n_keys; i++)
+      positions[i] = NOT_FOUND;
+    return 0;
+  }
+
+  if (pdict->order == SORTED || pdict->order == EYTZINGER)
+    return interleaved_search(pdict->table, pdict->n_data, keys, n_keys, positions);
+
+  for (i = 0; i < n_keys; i++)
+  {
+    if (pdict->order == HASHED)
+      st = hash_lookup64(pdict, keys[i], &positions[i]);
+    else
+      st = lin_search64(pdict->table, 0, pdict->n_data - 1, keys[i], &positions[i]);
+
+    if (st != ERR)
+      ob += st;
+  }
+
+  return ob;
+}
+
+/**
+ * Same as search_dictionary_batch, with the binary searches of sorted
+ * dictionaries vectorized LANES keys at a time with AVX2 gathers. The 
+ * remaining keys, or all of them without AVX2, go to 
+ * search_dictionary_batch
+ * @param pdict pointer to the dictionary
+ * @param keys keys to search
+ * @param n_keys number of keys
+ * @param positions where the position of each key, or NOT_FOUND, is stored
+ * @return Number of basic operations (of the keys found, out of the
+ *         sorted dictionaries)
+ */
+long simd_search_batch(PDICT pdict, const int *keys, long n_keys, long *positions)
+{
+  long done = 0, ob = 0;
+
+  /* Control de errores */
+  assert(pdict != NULL);
+  assert(keys != NULL || n_keys == 0);
+  assert(positions != NULL || n_keys == 0);
+
+#if SIMD_AVX2
+  if ((pdict->order == SORTED || pdict->order == EYTZINGER) && pdict->n_data > 0 &&
+      pdict->n_data <= INT_MAX && CPU_HAS_AVX2())
+  {
+    ob = gather_search_avx2(pdict->table, pdict->n_data, keys, n_keys, positions);
+    done = n_keys - n_keys % LANES;
+  }
+#endif
+
+  return ob + search_dictionary_batch(pdict, keys + done, n_keys - done, positions + done);
+}
+
+/**
+ * Task t of pool_search_batch: searches shard t of the keys with 
+ * simd_search_batch and adds its ob and comparisons to the caller's
+ * @param arg PAR_BATCH shared by the tasks
+ * @param t number of the shard
+ */
+static void par_batch_task(void *arg, int t)
+{
+  PPAR_BATCH pb = (PPAR_BATCH)arg;
+  long first, n, ob;
+  COUNTERS cuentas;
+  PCOUNTERS previas;
+
+  first = t * PAR_BATCH_SHARD;
+  n = first + PAR_BATCH_SHARD < pb->n_keys ? PAR_BATCH_SHARD : pb->n_keys - first;
+
+  reset_counters(&cuentas);
+  previas = set_counters(&cuentas);
+  ob = simd_search_batch(pb->pdict, pb->keys + first, n, pb->positions + first);
+  set_counters(previas);
+
+  __sync_fetch_and_add(&pb->ob, ob);
+  if (pb->counters != NULL)
+    __sync_fetch_and_add(&pb->counters->comparisons, cuentas.comparisons);
+}
+
+/**
+ * Parallel batch search: the keys are split in shards of PAR_BATCH_SHARD
+ * that the threads of ppool search with simd_search_batch in the shared
+ * dictionary, which is only read, writing each position in its place of
+ * positions. Batches of less than PAR_BATCH_MIN keys are searched by the
+ * calling thread. It must not be called from a task of the pool
+ * @param ppool pointer to the pool
+ * @param pdict pointer to the dictionary
+ * @param keys keys to search
+ * @param n_keys number of keys
+ * @param positions where the position of each key, or NOT_FOUND, is stored
+ * @return Number of basic operations (of the keys found, out of the
+ *         sorted dictionaries)
+ *         ERR in case of error
+ */
+long pool_search_batch(PPOOL ppool, PDICT pdict, const int *keys, long n_keys, long *positions)
+{
+  PAR_BATCH pb;
+  long n_shards;
+
+  /* Control de errores */
+  assert(pdict != NULL);
+  assert(keys != NULL || n_keys == 0);
+  assert(positions != NULL || n_keys == 0);
+
+  n_shards = (n_keys + PAR_BATCH_SHARD - 1) / PAR_BATCH_SHARD;
+  if (ppool == NULL || pool_size(ppool) == 1 || n_keys < PAR_BATCH_MIN || n_shards > INT_MAX)
+    return simd_search_batch(pdict, keys, n_keys, positions);
+
+  pb.pdict = pdict;
+  pb.keys = keys;
+  pb.n_keys = n_keys;
+  pb.positions = positions;
+  pb.ob = 0;
+  pb.counters = get_counters();
+
+  if (pool_run(ppool, (int)n_shards, par_batch_task, &pb) == ERR)
+    return ERR;
+
+  return pb.ob;
+}
+
+/**
+ * pool_search_batch on the pool shared by the library
+ * @param pdict pointer to the dictionary
+ * @param keys keys to search
+ * @param n_keys number of keys
+ * @param positions where the position of each key, or NOT_FOUND, is stored
+ * @return Number of basic operations (of the keys found, out of the
+ *         sorted dictionaries)
+ *         ERR in case of error
+ */
+long par_search_batch(PDICT pdict, const int *keys, long n_keys, long *positions)
+{
+  return pool_search_batch(default_pool(), pdict, keys, n_keys, positions);
+}
+
+/* int interface: thin wrappers over the 64-bit search functions. The ob
+ * saturate at INT_MAX (see narrow_ob in ob.c) */
+
+int bin_search(int *table, int F, int L, int key, int *ppos)
+{
+  long pos, ob;
+
+  ob = bin_search64(table, F, L, key, &pos);
+  *ppos = (int)pos;
+
+  return narrow_ob(ob);
+}
+
+int lin_search(int *table, int F, int L, int key, int *ppos)
+{
+  long pos, ob;
+
+  ob = lin_search64(table, F, L, key, &pos);
+  *ppos = (int)pos;
+
+  return narrow_ob(ob);
+}
+
+int lin_auto_search(int *table, int F, int L, int key, int *ppos)
+{
+  long pos, ob;
+
+  ob = lin_auto_search64(table, F, L, key, &pos);
+  *ppos = (int)pos;
+
+  return narrow_ob(ob);
+}
+
+int eytzinger_search(int *table, int F, int L, int key, int *ppos)
+{
+  long pos, ob;
+
+  ob = eytzinger_search64(table, F, L, key, &pos);
+  *ppos = (int)pos;
+
+  return narrow_ob(ob);
+}
+
+int branchless_search(int *table, int F, int L, int key, int *ppos)
+{
+  long pos, ob;
+
+  ob = branchless_search64(table, F, L, key, &pos);
+  *ppos = (int)pos;
+
+  return narrow_ob(ob);
+}
+
+int simd_lin_search(int *table, int F, int L, int key, int *ppos)
+{
+  long pos, ob;
+
+  ob = simd_lin_search64(table, F, L, key, &pos);
+  *ppos = (int)pos;
+
+  return narrow_ob(ob);
+}
+
+int par_lin_search(int *table, int F, int L, int key, int *ppos)
+{
+  long pos, ob;
+
+  ob = par_lin_search64(table, F, L, key, &pos);
+  *ppos = (int)pos;
+
+  return narrow_ob(ob);
+}
+
+int stree_search(int *table, int F, int L, int key, int *ppos)
+{
+  long pos, ob;
+
+  ob = stree_search64(table, F, L, key, &pos);
+  *ppos = (int)pos;
+
+  return narrow_ob(ob);
+}
+
+int interp_search(int *table, int F, int L, int key, int *ppos)
+{
+  long pos, ob;
+
+  ob = interp_search64(table, F, L, key, &pos);
+  *ppos = (int)pos;
+
+  return narrow_ob(ob);
+}
+
+int interp_guarded_search(int *table, int F, int L, int key, int *ppos)
+{
+  long pos, ob;
+
+  ob = interp_guarded_search64(table, F, L, key, &pos);
+  *ppos = (int)pos;
+
+  return narrow_ob(ob);
+}
+
+int gallop_search(int *table, int F, int L, int key, int *ppos)
+{
+  long pos = *ppos, ob;
+
+  ob = gallop_search64(table, F, L, key, &pos);
+  *ppos = (int)pos;
+
+  return narrow_ob(ob);
+}
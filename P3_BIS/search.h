@@ -12,6 +12,8 @@
 #ifndef SEARCH_H_
 #define SEARCH_H_
 
+#include "pool.h"
+
 /* constantes */
 
 #ifndef ERR
@@ -24,30 +26,192 @@
 
 #define SORTED 1
 #define NOT_SORTED 0
+/* Sorted table plus a copy in Eytzinger (breadth-first) layout, built the
+ * first time eytzinger_search is used after an insertion */
+#define EYTZINGER 2
+/* Unsorted table plus an open-addressing hash table of its keys, probed
+ * HASH_GROUP control bytes at a time (Swiss table) */
+#define HASHED 3
+
+/* eytzinger_search: the 16 descendants 4 levels below a node share one
+ * cache line, which is prefetched while the node is compared */
+#define EYTZ_PREFETCH 16
+#define EYTZ_ALIGN 64
+
+/* HASHED: slots of each group, control byte of an empty slot (the full 
+ * ones keep 7 bits of the hash) and maximum load in eighths */
+#define HASH_GROUP 16
+#define HASH_EMPTY 0x80
+#define HASH_LOAD 7
+
+/* Indexes of a sorted dictionary. With INDEX_STREE, the default of SORTED
+ * dictionaries, the binary searches of search_dictionary go through a
+ * static S-tree built over the table the first time it is searched after
+ * an insertion */
+#define INDEX_NONE 0
+#define INDEX_STREE 1
+
+/* S-tree: keys of each node (one cache line) and maximum number of levels */
+#define STREE_B 16
+#define STREE_MAX_HEIGHT 16
+
+/* interp_guarded_search: intervals of this size or smaller are scanned */
+#define INTERP_SEQUENTIAL 8
+
+/* search_dictionary_batch: binary searches in flight at once, each one
+ * prefetching its next probe while the others are compared */
+#define BATCH_SEARCH_LANES 16
+
+/* par_search_batch: batches of this number of keys or more are split in
+ * shards of PAR_BATCH_SHARD keys (a multiple of the 8 lanes of 
+ * simd_search_batch) among the threads of the pool */
+#define PAR_BATCH_MIN (1L << 15)
+#define PAR_BATCH_SHARD (1L << 13)
+
+/* par_lin_search: tables of this size or bigger are split in blocks of
+ * PAR_SEARCH_BLOCK among the threads of the pool, which check every
+ * PAR_SEARCH_STEP elements whether the key was already found before */
+#define PAR_SEARCH_MIN (1L << 18)
+#define PAR_SEARCH_BLOCK (1L << 16)
+#define PAR_SEARCH_STEP (1L << 12)
 
 /* type definitions */
 typedef struct dictionary {
-  int size; /* table size */
-  int n_data; /* number of entries in the table */
+  long size; /* table size */
+  long n_data; /* number of entries in the table */
   char order;  /* sorted or unsorted table */
   int *table;  /* data table */
+  int *eytz;   /* Eytzinger copy of table from eytz[1], NULL if not built */
+  long n_eytz; /* entries of table laid out in eytz */
+  char index;  /* INDEX_NONE or INDEX_STREE */
+  int *stree;  /* S-tree over table, NULL if not built */
+  long n_stree; /* entries of table in stree */
+  unsigned char *ctrl; /* HASHED: control byte of each slot */
+  int *hkeys;  /* HASHED: key of each slot */
+  long *hpos;  /* HASHED: position in table of the key of each slot */
+  long n_groups; /* HASHED: groups of HASH_GROUP slots, a power of 2 */
+  long finger; /* last position found by gallop_search, where it starts */
 } DICT, *PDICT;
 
 typedef int (* pfunc_search)(int*, int, int, int, int*);
+/* 64-bit interface: indices, positions and ob are long */
+typedef long (* pfunc_search64)(int*, long, long, int, long*);
 typedef void (* pfunc_key_generator)(int*, int, int);
+/* 64-bit interface: the number of keys is long */
+typedef void (* pfunc_key_generator64)(int*, long, int);
+/* Searches a batch of keys in a dictionary (search_dictionary_batch) */
+typedef long (* pfunc_search_batch)(PDICT, const int*, long, long*);
+
+/* search.c compiled with -DNO_OB gives the uncounted variant of every
+ * search function, with the same name followed by _nc (see ob.h) */
+#ifdef NO_OB
+  #define bin_search      bin_search_nc
+  #define lin_search      lin_search_nc
+  #define lin_auto_search lin_auto_search_nc
+  #define eytzinger_search eytzinger_search_nc
+  #define branchless_search branchless_search_nc
+  #define simd_lin_search simd_lin_search_nc
+  #define par_lin_search  par_lin_search_nc
+  #define stree_search    stree_search_nc
+  #define interp_search   interp_search_nc
+  #define interp_guarded_search interp_guarded_search_nc
+  #define gallop_search   gallop_search_nc
+  #define hash_lookup64   hash_lookup64_nc
+  #define search_dictionary_batch search_dictionary_batch_nc
+  #define simd_search_batch simd_search_batch_nc
+  #define par_search_batch par_search_batch_nc
+  #define pool_search_batch pool_search_batch_nc
+  #define bin_search64      bin_search64_nc
+  #define lin_search64      lin_search64_nc
+  #define lin_auto_search64 lin_auto_search64_nc
+  #define eytzinger_search64 eytzinger_search64_nc
+  #define branchless_search64 branchless_search64_nc
+  #define simd_lin_search64 simd_lin_search64_nc
+  #define par_lin_search64  par_lin_search64_nc
+  #define stree_search64    stree_search64_nc
+  #define interp_search64   interp_search64_nc
+  #define interp_guarded_search64 interp_guarded_search64_nc
+  #define gallop_search64   gallop_search64_nc
+#endif
 
 /* Dictionary ADT */
 PDICT init_dictionary (int size, char order);
+PDICT init_dictionary64 (long size, char order);
 void free_dictionary(PDICT pdict);
 int insert_dictionary(PDICT pdict, int key);
 int massive_insertion_dictionary (PDICT pdict,int *keys, int n_keys);
+long massive_insertion_dictionary64 (PDICT pdict,int *keys, long n_keys);
+int set_dictionary_index(PDICT pdict, char index);
 int search_dictionary(PDICT pdict, int key, int *ppos, pfunc_search method);
+long search_dictionary64(PDICT pdict, int key, long *ppos, pfunc_search64 method);
+long hash_lookup64(PDICT pdict, int key, long *ppos);
+long hash_lookup64_nc(PDICT pdict, int key, long *ppos);
+long search_dictionary_batch(PDICT pdict, const int *keys, long n_keys, long *positions);
+long search_dictionary_batch_nc(PDICT pdict, const int *keys, long n_keys, long *positions);
+long simd_search_batch(PDICT pdict, const int *keys, long n_keys, long *positions);
+long simd_search_batch_nc(PDICT pdict, const int *keys, long n_keys, long *positions);
+long par_search_batch(PDICT pdict, const int *keys, long n_keys, long *positions);
+long par_search_batch_nc(PDICT pdict, const int *keys, long n_keys, long *positions);
+long pool_search_batch(PPOOL ppool, PDICT pdict, const int *keys, long n_keys, long *positions);
+long pool_search_batch_nc(PPOOL ppool, PDICT pdict, const int *keys, long n_keys, long *positions);
+pfunc_search_batch uncounted_search_batch(pfunc_search_batch method);
 
 
 /* Search functions for the Dictionary ADT */
 int bin_search(int *table,int F,int L,int key, int *ppos);
 int lin_search(int *table,int F,int L,int key, int *ppos);
 int lin_auto_search(int *table,int F,int L,int key, int *ppos);
+int eytzinger_search(int *table,int F,int L,int key, int *ppos);
+int branchless_search(int *table,int F,int L,int key, int *ppos);
+int simd_lin_search(int *table,int F,int L,int key, int *ppos);
+int par_lin_search(int *table,int F,int L,int key, int *ppos);
+int stree_search(int *table,int F,int L,int key, int *ppos);
+int interp_search(int *table,int F,int L,int key, int *ppos);
+int interp_guarded_search(int *table,int F,int L,int key, int *ppos);
+int gallop_search(int *table,int F,int L,int key, int *ppos);
+
+/* 64-bit versions: the functions above are thin wrappers over them */
+long bin_search64(int *table,long F,long L,int key, long *ppos);
+long lin_search64(int *table,long F,long L,int key, long *ppos);
+long lin_auto_search64(int *table,long F,long L,int key, long *ppos);
+long eytzinger_search64(int *table,long F,long L,int key, long *ppos);
+long branchless_search64(int *table,long F,long L,int key, long *ppos);
+long simd_lin_search64(int *table,long F,long L,int key, long *ppos);
+long par_lin_search64(int *table,long F,long L,int key, long *ppos);
+long stree_search64(int *table,long F,long L,int key, long *ppos);
+long interp_search64(int *table,long F,long L,int key, long *ppos);
+long interp_guarded_search64(int *table,long F,long L,int key, long *ppos);
+long gallop_search64(int *table,long F,long L,int key, long *ppos);
+pfunc_search64 wide_search(pfunc_search method);
+
+/* Sorted rank of the node of an Eytzinger table of n entries */
+long eytzinger_rank(long node, long n);
+
+/* Uncounted variants, built from the same source */
+int bin_search_nc(int *table,int F,int L,int key, int *ppos);
+int lin_search_nc(int *table,int F,int L,int key, int *ppos);
+int lin_auto_search_nc(int *table,int F,int L,int key, int *ppos);
+int eytzinger_search_nc(int *table,int F,int L,int key, int *ppos);
+int branchless_search_nc(int *table,int F,int L,int key, int *ppos);
+int simd_lin_search_nc(int *table,int F,int L,int key, int *ppos);
+int par_lin_search_nc(int *table,int F,int L,int key, int *ppos);
+int stree_search_nc(int *table,int F,int L,int key, int *ppos);
+int interp_search_nc(int *table,int F,int L,int key, int *ppos);
+int interp_guarded_search_nc(int *table,int F,int L,int key, int *ppos);
+int gallop_search_nc(int *table,int F,int L,int key, int *ppos);
+pfunc_search uncounted_search(pfunc_search method);
+long bin_search64_nc(int *table,long F,long L,int key, long *ppos);
+long lin_search64_nc(int *table,long F,long L,int key, long *ppos);
+long lin_auto_search64_nc(int *table,long F,long L,int key, long *ppos);
+long eytzinger_search64_nc(int *table,long F,long L,int key, long *ppos);
+long branchless_search64_nc(int *table,long F,long L,int key, long *ppos);
+long simd_lin_search64_nc(int *table,long F,long L,int key, long *ppos);
+long par_lin_search64_nc(int *table,long F,long L,int key, long *ppos);
+long stree_search64_nc(int *table,long F,long L,int key, long *ppos);
+long interp_search64_nc(int *table,long F,long L,int key, long *ppos);
+long interp_guarded_search64_nc(int *table,long F,long L,int key, long *ppos);
+long gallop_search64_nc(int *table,long F,long L,int key, long *ppos);
+pfunc_search64 uncounted_search64(pfunc_search64 method);
 
 /**
  *  Key generation functions
@@ -59,6 +223,8 @@ int lin_auto_search(int *table,int F,int L,int key, int *ppos);
  */
 void uniform_key_generator(int *keys, int n_keys, int max);
 void potential_key_generator(int *keys, int n_keys, int max);
+void uniform_key_generator64(int *keys, long n_keys, int max);
+void potential_key_generator64(int *keys, long n_keys, int max);
 
 
 
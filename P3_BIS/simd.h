@@ -0,0 +1,44 @@
+/**
+ *
+ * Descripcion: Macros to compile vector kernels and check at run time 
+ *              that the CPU supports them
+ *
+ * Fichero: simd.h
+ * Autor: Ignacio Sánchez and Fabio Desio
+ * Version: 1.1
+ * Fecha: 18-10-2026
+ *
+ */
+
+#ifndef SIMD_H
+#define SIMD_H
+
+/* AVX2 kernels are only compiled with gcc/clang on x86. They are built with
+ * the target attribute, so the rest of the program does not need -mavx2, 
+ * and they must only be called when CPU_HAS_AVX2() is true */
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+  #define SIMD_AVX2 1
+  #include <immintrin.h>
+  #define TARGET_AVX2 __attribute__((target("avx2")))
+  #define CPU_HAS_AVX2() __builtin_cpu_supports("avx2")
+  /* SSE2 gives the non-temporal (streaming) stores */
+  #define SIMD_SSE2 1
+  #define TARGET_SSE2 __attribute__((target("sse2")))
+  #define CPU_HAS_SSE2() __builtin_cpu_supports("sse2")
+#else
+  #define SIMD_AVX2 0
+  #define TARGET_AVX2
+  #define CPU_HAS_AVX2() 0
+  #define SIMD_SSE2 0
+  #define TARGET_SSE2
+  #define CPU_HAS_SSE2() 0
+#endif
+
+/* Prefetch of the cache line of p for reading, a no-op elsewhere */
+#if defined(__GNUC__)
+  #define PREFETCH(p) __builtin_prefetch(p)
+#else
+  #define PREFETCH(p) ((void)0)
+#endif
+
+#endif
@@ -9,10 +9,38 @@
  *
  */
 
+#define _POSIX_C_SOURCE 200112L
+
 #include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <limits.h>
 #include <assert.h>
+#include <unistd.h>
 #include "sorting.h"
 #include "swap.h"
+#include "simd.h"
+#include "networks.h"
+#include "ob.h"
+
+/* Configuración compartida por las dos variantes de este fichero (ver ob.h):
+ * la define la variante que cuenta ob y la usa también la variante _nc */
+#ifndef NO_OB
+/* Tamaño máximo de los casos base que se ordenan con una red de
+ * ordenación, 1 para recurrir hasta un elemento */
+int sort_base_case = 1;
+/* Camino usado por merge, se cambia con set_merge_path */
+int sort_merge_path = MERGE_SCALAR;
+/* Bytes a partir de los que merge copia con escrituras no temporales, se
+ * cambia con set_stream_threshold */
+long sort_stream_threshold = STREAM_AUTO;
+/* Destino de las trazas de adaptive_sort, NULL si no se registran */
+static FILE *adaptive_log = NULL;
+#else
+extern int sort_base_case;
+extern int sort_merge_path;
+extern long sort_stream_threshold;
+#endif
 
 /********************************************************/
 /* Function: SelectSort Date:                           */
@@ -23,15 +51,15 @@
 /*                                                      */
 /* Input:                                               */
 /* int *array: integer table                            */
-/* int ip: first index of the array                     */
-/* int iu: last index of the array                      */
+/* long ip: first index of the array                    */
+/* long iu: last index of the array                     */
 /* Output:                                              */
-/* int ob: number of ob performed during the ordenation */
+/* long ob: number of ob performed during the ordenation*/
 /* ERR in case of error                                 */
 /********************************************************/
-int SelectSort(int *array, int ip, int iu)
+long SelectSort64(int *array, long ip, long iu)
 {
-  int i, ob = 0, minimum;
+  long i, ob = 0, minimum;
 
   if (array == NULL || ip < 0 || iu < ip)
   {
@@ -40,8 +68,8 @@ int SelectSort(int *array, int ip, int iu)
 
   for (i = ip; i < iu; i++)
   {
-    minimum = min(array, i, iu, &ob);
-    swap(array + i, array + minimum);
+    minimum = min64(array, i, iu, &ob);
+    SWAP(array + i, array + minimum);
   }
 
   return ob;
@@ -56,15 +84,15 @@ int SelectSort(int *array, int ip, int iu)
 /*                                                   */
 /* Input:                                            */
 /* int *array: integer table                         */
-/* int ip: first index of the array                  */
-/* int iu: last index of the array                   */
+/* long ip: first index of the array                 */
+/* long iu: last index of the array                  */
 /* Output:                                           */
-/* int ob: number of ob performed during the sorting */
+/* long ob: number of ob performed during the sorting*/
 /* ERR in case of error                              */
 /*****************************************************/
-int SelectSortInv(int *array, int ip, int iu)
+long SelectSortInv64(int *array, long ip, long iu)
 {
-  int i, ob = 0, minimum;
+  long i, ob = 0, minimum;
 
   if (array == NULL || ip < 0 || iu < ip)
   {
@@ -73,8 +101,8 @@ int SelectSortInv(int *array, int ip, int iu)
 
   for (i = iu; i > 0; i--)
   {
-    minimum = min(array, ip, i, &ob);
-    swap(array + i, array + minimum);
+    minimum = min64(array, ip, i, &ob);
+    SWAP(array + i, array + minimum);
   }
 
   return ob;
@@ -90,17 +118,17 @@ int SelectSortInv(int *array, int ip, int iu)
 /*                                                */
 /* Input:                                         */
 /* int *array: table of integers                  */
-/* int ip: first index of the array               */
-/* int iu: last index of the array                */
-/* int *ob: pointer that saves the number of      */
+/* long ip: first index of the array              */
+/* long iu: last index of the array               */
+/* long *ob: pointer that saves the number of     */
 /* comparisons made                               */
 /* Output:                                        */
-/* int min: index of the smallest element         */
+/* long min: index of the smallest element        */
 /* ERR in case of error                           */
 /**************************************************/
-int min(int *array, int ip, int iu, int *ob)
+long min64(int *array, long ip, long iu, long *ob)
 {
-  int i, min;
+  long i, min;
 
   if (array == NULL || ip < 0 || iu < ip)
   {
@@ -111,8 +139,7 @@ int min(int *array, int ip, int iu, int *ob)
 
   for (i = ip; i <= iu; i++)
   {
-    (*ob)++;
-    if (array[i] < array[min])
+    if (OB(*ob) && array[i] < array[min])
     {
       min = i;
     }
@@ -121,6 +148,203 @@ int min(int *array, int ip, int iu, int *ob)
   return min;
 }
 
+/**
+ * Sorts a small range with the sorting network of its size
+ * @param tabla pointer to an array of integers
+ * @param ip first index of the array
+ * @param iu last index of the array (iu - ip < SORTNET_MAX)
+ * @return Number of basic operations (comparators of the network)
+ */
+static long network_sort(int *tabla, long ip, long iu)
+{
+  int n_cmp;
+
+  /* Las redes trabajan con índices int: les pasamos el rango desplazado */
+  n_cmp = sorting_network(tabla + ip, 0, (int)(iu - ip));
+
+  /* Cada comparador compara dos claves y escribe dos elementos */
+  COUNT_CMP(n_cmp);
+  COUNT_MOVE(2 * n_cmp);
+
+  return n_cmp;
+}
+
+#if SIMD_AVX2
+/**
+ * Sorts a bitonic sequence of 8 ints held in one register comparing
+ * lanes at distance 4, 2 and 1
+ * @param v bitonic register
+ * @return Sorted register
+ */
+TARGET_AVX2 static __m256i bitonic_clean(__m256i v)
+{
+  __m256i t;
+
+  t = _mm256_permute2x128_si256(v, v, 1);
+  v = _mm256_blend_epi32(_mm256_min_epi32(v, t), _mm256_max_epi32(v, t), 0xF0);
+  t = _mm256_shuffle_epi32(v, _MM_SHUFFLE(1, 0, 3, 2));
+  v = _mm256_blend_epi32(_mm256_min_epi32(v, t), _mm256_max_epi32(v, t), 0xCC);
+  t = _mm256_shuffle_epi32(v, _MM_SHUFFLE(2, 3, 0, 1));
+  v = _mm256_blend_epi32(_mm256_min_epi32(v, t), _mm256_max_epi32(v, t), 0xAA);
+
+  return v;
+}
+
+/**
+ * Bitonic merge of two sorted registers: leaves the 8 smallest elements
+ * sorted in *a and the 8 largest sorted in *b
+ * @param a pointer to the first sorted register
+ * @param b pointer to the second sorted register
+ */
+TARGET_AVX2 static void bitonic_merge(__m256i *a, __m256i *b)
+{
+  __m256i r, lo;
+
+  /* a seguido de b invertido es bitónica */
+  r = _mm256_permutevar8x32_epi32(*b, _mm256_set_epi32(0, 1, 2, 3, 4, 5, 6, 7));
+  lo = _mm256_min_epi32(*a, r);
+  *b = bitonic_clean(_mm256_max_epi32(*a, r));
+  *a = bitonic_clean(lo);
+}
+
+/**
+ * Merge of tabla[ip..imedio] and tabla[imedio+1..iu] into aux, 8 elements
+ * per step with a bitonic network. Each step emits the 8 smallest elements
+ * of the two registers and reloads from the run with the smallest head.
+ * The last register and the tails are merged by the scalar code. Every 
+ * vector step counts MERGE_LANES ob, one per element placed, like merge
+ * @param tabla pointer to an array of integers
+ * @param ip first index of the array
+ * @param iu last index of the array
+ * @param imedio medium index of the array
+ * @param aux table of iu - ip + 1 elements where the result is left
+ * @return Number of basic operations performed by the algorithm
+ */
+TARGET_AVX2 static long merge_avx2(int *tabla, long ip, long iu, long imedio, int *aux)
+{
+  __m256i a, b;
+  int rest[MERGE_LANES];
+  long i, j, k, na, nb, ob = 0;
+  int r;
+
+  a = _mm256_loadu_si256((__m256i *)(tabla + ip));
+  b = _mm256_loadu_si256((__m256i *)(tabla + imedio + 1));
+  i = ip + MERGE_LANES;
+  j = imedio + 1 + MERGE_LANES;
+  k = 0;
+
+  while (1)
+  {
+    OB_ADD(ob, MERGE_LANES);
+    COUNT_CMP(BITONIC_MERGE_CMP);
+    bitonic_merge(&a, &b);
+    _mm256_storeu_si256((__m256i *)(aux + k), a);
+    k += MERGE_LANES;
+
+    /* Recargamos de la mitad con la cabeza más pequeña. Si a la otra le
+     * quedan menos de MERGE_LANES elementos termina el código escalar */
+    na = imedio - i + 1;
+    nb = iu - j + 1;
+    if (na >= MERGE_LANES && (nb == 0 || (nb >= MERGE_LANES && OB(ob) && tabla[i] < tabla[j])))
+    {
+      a = _mm256_loadu_si256((__m256i *)(tabla + i));
+      i += MERGE_LANES;
+    }
+    else if (nb >= MERGE_LANES && (na == 0 || na >= MERGE_LANES))
+    {
+      a = _mm256_loadu_si256((__m256i *)(tabla + j));
+      j += MERGE_LANES;
+    }
+    else
+    {
+      break;
+    }
+  }
+
+  /* Mezcla escalar de tres secuencias: el registro pendiente y las colas */
+  _mm256_storeu_si256((__m256i *)rest, b);
+  r = 0;
+  while (r < MERGE_LANES || i <= imedio || j <= iu)
+  {
+    if (r < MERGE_LANES && (i > imedio || (OB(ob) && rest[r] <= tabla[i])) && (j > iu || (OB(ob) && rest[r] <= tabla[j])))
+      aux[k++] = rest[r++];
+    else if (i <= imedio && (j > iu || (OB(ob) && tabla[i] < tabla[j])))
+      aux[k++] = tabla[i++];
+    else
+      aux[k++] = tabla[j++];
+  }
+
+  return ob;
+}
+#else
+static long merge_avx2(int *tabla, long ip, long iu, long imedio, int *aux)
+{
+  return ERR;
+}
+#endif
+
+/**
+ * Returns the number of bytes from which merge copies back with streaming
+ * stores. With STREAM_AUTO it is the size of the last level cache, 
+ * detected once
+ * @return Threshold in bytes, LONG_MAX if merge must not stream
+ */
+static long stream_limit(void)
+{
+  static long llc = 0;
+
+  if (sort_stream_threshold == STREAM_OFF)
+    return LONG_MAX;
+
+  if (sort_stream_threshold != STREAM_AUTO)
+    return sort_stream_threshold;
+
+  /* Tamaño desconocido: no arriesgamos escrituras no temporales */
+  if (llc == 0)
+  {
+    llc = sysconf(_SC_LEVEL3_CACHE_SIZE);
+    if (llc <= 0)
+      llc = LONG_MAX;
+  }
+
+  return llc;
+}
+
+#if SIMD_SSE2
+/**
+ * Copies n ints with non-temporal stores, which write to memory without
+ * bringing the lines to the cache, and a final fence so that they are
+ * visible before returning
+ * @param dst destination table
+ * @param src source table
+ * @param n number of elements
+ */
+TARGET_SSE2 static void stream_copy(int *dst, int *src, long n)
+{
+  long i = 0;
+
+  /* Elementos sueltos hasta alinear el destino a 16 bytes */
+  for (; i < n && ((size_t)(dst + i) & 15) != 0; i++)
+    dst[i] = src[i];
+
+  for (; i + 4 <= n; i += 4)
+    _mm_stream_si128((__m128i *)(dst + i), _mm_loadu_si128((__m128i *)(src + i)));
+
+  for (; i < n; i++)
+    dst[i] = src[i];
+
+  _mm_sfence();
+}
+#else
+static void stream_copy(int *dst, int *src, long n)
+{
+  long i;
+
+  for (i = 0; i < n; i++)
+    dst[i] = src[i];
+}
+#endif
+
 /**
  * Recursive sorting algorithm of an array of integers that divides the array 
  * into two smaller arrays and sorts them from bottom to top using the merge routine
@@ -129,10 +353,10 @@ int min(int *array, int ip, int iu, int *ob)
  * @param iu last index of the array
  * @return Number of basic operations performed by the algorithm
  */
-int mergesort(int *tabla, int ip, int iu)
+long mergesort64(int *tabla, long ip, long iu)
 {
-  int ob = 0;
-  int imedio;
+  long ob = 0;
+  long imedio;
   /* Control de errores */
   assert(tabla != NULL);
   assert(ip >= 0);
@@ -142,14 +366,18 @@ int mergesort(int *tabla, int ip, int iu)
   if (iu == ip)
     return OK;
 
-  imedio = (iu + ip) / 2;
+  /* Rangos pequeños con red de ordenación */
+  if (iu - ip < sort_base_case)
+    return network_sort(tabla, ip, iu);
+
+  imedio = ip + (iu - ip) / 2;
 
   /* Separamos en dos mitades recursivas */
-  ob += mergesort(tabla, ip, imedio);
-  ob += mergesort(tabla, imedio + 1, iu);
+  ob += mergesort64(tabla, ip, imedio);
+  ob += mergesort64(tabla, imedio + 1, iu);
 
   /* Hacemos merge */
-  ob += merge(tabla, ip, iu, imedio);
+  ob += merge64(tabla, ip, iu, imedio);
 
   return ob;
 }
@@ -163,9 +391,10 @@ int mergesort(int *tabla, int ip, int iu)
  * @param imedio medium index of the array
  * @return Number of basic operations performed by the algorithm
  */
-int merge(int *tabla, int ip, int iu, int imedio)
+long merge64(int *tabla, long ip, long iu, long imedio)
 {
-  int *aux = NULL, size, i, j, k, ob = 0;
+  int *aux = NULL;
+  long size, i, j, k, ob = 0;
   /* Control de errores */
   assert(tabla != NULL);
   assert(ip >= 0);
@@ -177,46 +406,66 @@ int merge(int *tabla, int ip, int iu, int imedio)
   aux = (int *)malloc(sizeof(aux[0]) * size);
   /* Hacemos assert pues no debemos liberar nada en caso de error */
   assert(aux != NULL);
+  COUNT_ALLOC();
 
-  for (i = ip, j = imedio + 1, k = 0; i <= imedio && j <= iu && k < size; k++)
+  /* Camino vectorial si está activado y ambas mitades llenan un registro */
+  if (sort_merge_path == MERGE_AVX2 && imedio - ip + 1 >= MERGE_LANES && iu - imedio >= MERGE_LANES)
   {
-    /* Comparación de claves */
-    if (++ob && tabla[i] < tabla[j])
+    ob = merge_avx2(tabla, ip, iu, imedio, aux);
+  }
+  else
+  {
+    for (i = ip, j = imedio + 1, k = 0; i <= imedio && j <= iu && k < size; k++)
     {
-      aux[k] = tabla[i];
-      i++;
+      /* Comparación de claves */
+      if (OB(ob) && tabla[i] < tabla[j])
+      {
+        aux[k] = tabla[i];
+        i++;
+      }
+      else
+      {
+        aux[k] = tabla[j];
+        j++;
+      }
     }
-    else
+
+    /* Copiamos resto de la tabla derecha */
+    if (i > imedio)
+    {
+      while (OB_CHECK(ob) && j <= iu)
+      {
+        aux[k] = tabla[j];
+        j++;
+        k++;
+      }
+    } /* Copiamos el resto de la tabla izquierda */
+    else if (j > iu)
     {
-      aux[k] = tabla[j];
-      j++;
+      while (OB_CHECK(ob) && i <= imedio)
+      {
+        aux[k] = tabla[i];
+        i++;
+        k++;
+      }
     }
   }
 
-  /* Copiamos resto de la tabla derecha */
-  if (i > imedio)
+  /* Rangos mayores que la caché: la copia no la contamina */
+  if (size * (long)sizeof(int) > stream_limit())
   {
-    while (++ob && j <= iu)
-    {
-      aux[k] = tabla[j];
-      j++;
-      k++;
-    }
-  } /* Copiamos el resto de la tabla izquierda */
-  else if (j > iu)
+    stream_copy(tabla + ip, aux, size);
+  }
+  else
   {
-    while (++ob && i <= imedio)
+    for (k = 0; k < size; k++)
     {
-      aux[k] = tabla[i];
-      i++;
-      k++;
+      tabla[ip + k] = aux[k];
     }
   }
 
-  for (k = 0; k < size; k++)
-  {
-    tabla[ip + k] = aux[k];
-  }
+  /* Cada elemento se escribe en aux y se copia de vuelta */
+  COUNT_MOVE(2 * size);
 
   free(aux);
 
@@ -231,9 +480,9 @@ int merge(int *tabla, int ip, int iu, int imedio)
  * @param iu last index of the array
  * @return Number of basic operations performed by the algorithm
  */
-int quicksort(int *tabla, int ip, int iu)
+long quicksort64(int *tabla, long ip, long iu)
 {
-  int pos, ob = 0;
+  long pos, ob = 0;
 
   /* Control de errores */
   assert(tabla != NULL);
@@ -244,15 +493,19 @@ int quicksort(int *tabla, int ip, int iu)
   if (iu == ip)
     return OK;
 
+  /* Rangos pequeños con red de ordenación */
+  if (iu - ip < sort_base_case)
+    return network_sort(tabla, ip, iu);
+
   /* Realizamos la partición */
-  ob += partition(tabla, ip, iu, &pos);
+  ob += partition64(tabla, ip, iu, &pos);
 
   /*Recursión*/
   if (ip < pos - 1)
-    ob += quicksort(tabla, ip, pos - 1);
+    ob += quicksort64(tabla, ip, pos - 1);
 
   if (pos + 1 < iu)
-    ob += quicksort(tabla, pos + 1, iu);
+    ob += quicksort64(tabla, pos + 1, iu);
 
   return ob;
 }
@@ -267,34 +520,35 @@ int quicksort(int *tabla, int ip, int iu)
  * @param pos pointer to the index of the element used as pivot
  * @return Number of basic operations performed by the algorithm
  */
-int partition(int *tabla, int ip, int iu, int *pos)
+long partition64(int *tabla, long ip, long iu, long *pos)
 {
-  int ele, i, ob = 0;
+  long i, ob = 0;
+  int ele;
   /* CONTROL DE ERRORES */
   assert(tabla != NULL);
   assert(ip >= 0);
   assert(iu >= ip);
   assert(pos != NULL);
 
-  ob += median(tabla, ip, iu, pos);
+  ob += median64(tabla, ip, iu, pos);
 
   ele = tabla[*pos];
   /* Realizamos un primer swap */
-  swap(&tabla[ip], &ele);
+  SWAP(&tabla[ip], &ele);
 
   *pos = ip;
 
   for (i = ip + 1; i <= iu; i++)
   {
     /* Comparación de claves */
-    if (++ob && tabla[i] < ele)
+    if (OB(ob) && tabla[i] < ele)
     {
       (*pos)++;
-      swap(&tabla[i], &tabla[*pos]);
+      SWAP(&tabla[i], &tabla[*pos]);
     }
   }
 
-  swap(&tabla[ip], &tabla[*pos]);
+  SWAP(&tabla[ip], &tabla[*pos]);
 
   return ob;
 }
@@ -307,7 +561,7 @@ int partition(int *tabla, int ip, int iu, int *pos)
  * @param pos pointer to the index of the element used as pivot
  * @return Number of basic operations performed by the algorithm
  */
-int median(int *tabla, int ip, int iu, int *pos)
+long median64(int *tabla, long ip, long iu, long *pos)
 {
   /* CONTROL DE ERRORES */
   assert(tabla != NULL);
@@ -329,7 +583,7 @@ int median(int *tabla, int ip, int iu, int *pos)
  * @param pos pointer to the index of the element used as pivot
  * @return Number of basic operations performed by the algorithm
  */
-int median_avg(int *tabla, int ip, int iu, int *pos)
+long median_avg64(int *tabla, long ip, long iu, long *pos)
 {
   /* CONTROL DE ERRORES */
   assert(tabla != NULL);
@@ -337,7 +591,7 @@ int median_avg(int *tabla, int ip, int iu, int *pos)
   assert(iu >= ip);
   assert(pos != NULL);
 
-  *pos = (ip + iu) / 2;
+  *pos = ip + (iu - ip) / 2;
 
   return OK;
 }
@@ -351,28 +605,29 @@ int median_avg(int *tabla, int ip, int iu, int *pos)
  * @param pos pointer to the index of the element used as pivot
  * @return Number of basic operations performed by the algorithm
  */
-int median_stat(int *tabla, int ip, int iu, int *pos)
+long median_stat64(int *tabla, long ip, long iu, long *pos)
 {
-  int e1, e2, e3, im, ob = 0;
+  int e1, e2, e3;
+  long im, ob = 0;
   /* CONTROL DE ERRORES */
   assert(tabla != NULL);
   assert(ip >= 0);
   assert(iu >= ip);
   assert(pos != NULL);
 
-  im = (ip + iu) / 2;
+  im = ip + (iu - ip) / 2;
   e1 = tabla[ip];
   e2 = tabla[iu];
   e3 = tabla[im];
 
   /* Algoritmo de comparación de tres elementos */
-  if (++ob && e1 < e2)
+  if (OB(ob) && e1 < e2)
   {
-    if (++ob && e2 <= e3)
+    if (OB(ob) && e2 <= e3)
     {
       *pos = iu;
     }
-    else if (++ob && e1 < e3)
+    else if (OB(ob) && e1 < e3)
     {
       *pos = im;
     }
@@ -383,11 +638,11 @@ int median_stat(int *tabla, int ip, int iu, int *pos)
   }
   else
   {
-    if (++ob && e2 >= e3)
+    if (OB(ob) && e2 >= e3)
     {
       *pos = iu;
     }
-    else if (++ob && e1 > e3)
+    else if (OB(ob) && e1 > e3)
     {
       *pos = im;
     }
@@ -398,4 +653,2031 @@ int median_stat(int *tabla, int ip, int iu, int *pos)
   }
 
   return ob;
-}
\ No newline at end of file
+}
+
+/**
+ * Sorting algorithm that inserts each element in its place inside the 
+ * already sorted prefix of the array. Used as base case of the adaptive engines
+ * @param tabla pointer to an array of integers
+ * @param ip first index of the array
+ * @param iu last index of the array
+ * @return Number of basic operations performed by the algorithm
+ */
+long InsertSort64(int *tabla, long ip, long iu)
+{
+  long i, j, ob = 0;
+  int ele;
+  /* Control de errores */
+  assert(tabla != NULL);
+  assert(ip >= 0);
+  assert(iu >= ip);
+
+  for (i = ip + 1; i <= iu; i++)
+  {
+    ele = tabla[i];
+    /* Desplazamos los mayores una posición a la derecha */
+    for (j = i - 1; j >= ip && OB(ob) && tabla[j] > ele; j--)
+    {
+      tabla[j + 1] = tabla[j];
+      COUNT_MOVE(1);
+    }
+    tabla[j + 1] = ele;
+    COUNT_MOVE(1);
+  }
+
+  return ob;
+}
+
+/**
+ * Restores the heap property of the subtree rooted at position i of a 
+ * max-heap stored in tabla[ip..ip+n-1]
+ * @param tabla pointer to an array of integers
+ * @param ip first index of the heap
+ * @param n number of elements of the heap
+ * @param i position (relative to ip) of the root of the subtree
+ * @return Number of basic operations performed by the algorithm
+ */
+static long heapify(int *tabla, long ip, long n, long i)
+{
+  long child, ob = 0;
+
+  while ((child = 2 * i + 1) < n)
+  {
+    /* Elegimos el mayor de los dos hijos */
+    if (child + 1 < n && OB(ob) && tabla[ip + child] < tabla[ip + child + 1])
+      child++;
+
+    if (OB(ob) && tabla[ip + i] >= tabla[ip + child])
+      break;
+
+    SWAP(&tabla[ip + i], &tabla[ip + child]);
+    i = child;
+  }
+
+  return ob;
+}
+
+/**
+ * Heapsort. Sorts the array in O(N log N) in the worst case, it is used 
+ * by introsort to bound the cost of bad partitions
+ * @param tabla pointer to an array of integers
+ * @param ip first index of the array
+ * @param iu last index of the array
+ * @return Number of basic operations performed by the algorithm
+ */
+long HeapSort64(int *tabla, long ip, long iu)
+{
+  long i, n, ob = 0;
+  /* Control de errores */
+  assert(tabla != NULL);
+  assert(ip >= 0);
+  assert(iu >= ip);
+
+  n = iu - ip + 1;
+
+  /* Construimos el heap */
+  for (i = n / 2 - 1; i >= 0; i--)
+    ob += heapify(tabla, ip, n, i);
+
+  /* Extraemos el máximo y lo llevamos al final */
+  for (i = n - 1; i > 0; i--)
+  {
+    SWAP(&tabla[ip], &tabla[ip + i]);
+    ob += heapify(tabla, ip, i, 0);
+  }
+
+  return ob;
+}
+
+/**
+ * Recursive step of introsort. Partitions with the median of three pivot
+ * and falls back to heapsort when the recursion depth reaches the limit
+ * @param tabla pointer to an array of integers
+ * @param ip first index of the array
+ * @param iu last index of the array
+ * @param depth remaining recursion depth
+ * @return Number of basic operations performed by the algorithm
+ */
+static long introsort_rec(int *tabla, long ip, long iu, int depth)
+{
+  long pos, i, ob = 0;
+  int ele;
+
+  while (iu - ip + 1 > INTRO_SMALL)
+  {
+    /* Demasiadas particiones malas: acotamos con heapsort */
+    if (depth-- == 0)
+      return ob + HeapSort64(tabla, ip, iu);
+
+    ob += median_stat64(tabla, ip, iu, &pos);
+
+    /* Partición de Lomuto con el pivote al principio */
+    SWAP(&tabla[ip], &tabla[pos]);
+    ele = tabla[ip];
+    pos = ip;
+    for (i = ip + 1; i <= iu; i++)
+    {
+      if (OB(ob) && tabla[i] < ele)
+      {
+        pos++;
+        SWAP(&tabla[i], &tabla[pos]);
+      }
+    }
+    SWAP(&tabla[ip], &tabla[pos]);
+
+    /* Recursión sobre la mitad pequeña, iteración sobre la grande */
+    if (pos - ip < iu - pos)
+    {
+      if (ip < pos - 1)
+        ob += introsort_rec(tabla, ip, pos - 1, depth);
+      ip = pos + 1;
+    }
+    else
+    {
+      if (pos + 1 < iu)
+        ob += introsort_rec(tabla, pos + 1, iu, depth);
+      iu = pos - 1;
+    }
+  }
+
+  if (ip < iu && iu - ip < sort_base_case)
+    ob += network_sort(tabla, ip, iu);
+  else if (ip < iu)
+    ob += InsertSort64(tabla, ip, iu);
+
+  return ob;
+}
+
+/**
+ * Introsort: quicksort with median of three pivot whose recursion depth 
+ * is bounded by 2*log2(N), after which heapsort is used. Small ranges are 
+ * sorted by insertion
+ * @param tabla pointer to an array of integers
+ * @param ip first index of the array
+ * @param iu last index of the array
+ * @return Number of basic operations performed by the algorithm
+ */
+long introsort64(int *tabla, long ip, long iu)
+{
+  long n;
+  int depth = 0;
+  /* Control de errores */
+  assert(tabla != NULL);
+  assert(ip >= 0);
+  assert(iu >= ip);
+
+  for (n = iu - ip + 1; n > 1; n >>= 1)
+    depth += 2;
+
+  return introsort_rec(tabla, ip, iu, depth);
+}
+
+/**
+ * Leaves in tabla[ip..ip+m-1] the m smallest elements of tabla[ip..iu] in
+ * ascending order, keeping a max-heap of the m smallest seen so far. Takes
+ * O(N log m) in the worst case
+ * @param tabla pointer to an array of integers
+ * @param ip first index of the array
+ * @param iu last index of the array
+ * @param m number of elements to select, 1 <= m <= iu - ip + 1
+ * @return Number of basic operations performed by the algorithm
+ */
+static long heap_select(int *tabla, long ip, long iu, long m)
+{
+  long i, ob = 0;
+
+  for (i = m / 2 - 1; i >= 0; i--)
+    ob += heapify(tabla, ip, m, i);
+
+  /* Cada elemento menor que la raíz la sustituye */
+  for (i = ip + m; i <= iu; i++)
+  {
+    if (OB(ob) && tabla[i] < tabla[ip])
+    {
+      SWAP(&tabla[ip], &tabla[i]);
+      ob += heapify(tabla, ip, m, 0);
+    }
+  }
+
+  for (i = m - 1; i > 0; i--)
+  {
+    SWAP(&tabla[ip], &tabla[ip + i]);
+    ob += heapify(tabla, ip, i, 0);
+  }
+
+  return ob;
+}
+
+/**
+ * Partial sort: leaves the k smallest elements of the array sorted in 
+ * tabla[ip..ip+k-1], the rest in tabla[ip+k..iu] in any order. Partitions
+ * like introsort but only recurses into the parts that hold some of the 
+ * first k positions, sorting whole the parts that fall inside them. When
+ * the recursion depth reaches the limit it selects with a heap of size k
+ * @param tabla pointer to an array of integers
+ * @param ip first index of the array
+ * @param iu last index of the array
+ * @param k number of elements to sort, it is cut to the size of the array
+ * @return Number of basic operations performed by the algorithm
+ */
+long partial_sort64(int *tabla, long ip, long iu, long k)
+{
+  long n, pos, i, lim, ob = 0;
+  int ele, depth = 0;
+  /* Control de errores */
+  assert(tabla != NULL);
+  assert(ip >= 0);
+  assert(iu >= ip);
+  assert(k >= 0);
+
+  if (k > iu - ip + 1)
+    k = iu - ip + 1;
+  if (k == 0)
+    return ob;
+
+  /* Última posición que debe quedar ordenada */
+  lim = ip + k - 1;
+
+  for (n = iu - ip + 1; n > 1; n >>= 1)
+    depth += 2;
+
+  while (ip <= lim && iu - ip + 1 > INTRO_SMALL)
+  {
+    if (depth-- == 0)
+      return ob + heap_select(tabla, ip, iu, lim - ip + 1);
+
+    ob += median_stat64(tabla, ip, iu, &pos);
+
+    /* Partición de Lomuto con el pivote al principio */
+    SWAP(&tabla[ip], &tabla[pos]);
+    ele = tabla[ip];
+    pos = ip;
+    for (i = ip + 1; i <= iu; i++)
+    {
+      if (OB(ob) && tabla[i] < ele)
+      {
+        pos++;
+        SWAP(&tabla[i], &tabla[pos]);
+      }
+    }
+    SWAP(&tabla[ip], &tabla[pos]);
+
+    /* La parte izquierda cae entera dentro de las k primeras */
+    if (pos <= lim)
+    {
+      if (ip < pos - 1)
+        ob += introsort_rec(tabla, ip, pos - 1, depth);
+      ip = pos + 1;
+    }
+    else
+    {
+      iu = pos - 1;
+    }
+  }
+
+  if (ip <= lim && ip < iu && iu - ip < sort_base_case)
+    ob += network_sort(tabla, ip, iu);
+  else if (ip <= lim && ip < iu)
+    ob += InsertSort64(tabla, ip, iu);
+
+  return ob;
+}
+
+/**
+ * Creates a streaming top-k accumulator, that keeps the k smallest 
+ * elements of all the chunks given to topk_push in O(k) memory
+ * @param k number of elements to keep
+ * @return Pointer to the accumulator
+ *         NULL in case of error
+ */
+PTOPK topk_init(long k)
+{
+  PTOPK ptopk = NULL;
+
+  if (k < 1)
+    return NULL;
+
+  ptopk = (PTOPK)malloc(sizeof(ptopk[0]));
+  if (ptopk == NULL)
+    return NULL;
+
+  ptopk->heap = (int *)malloc((size_t)k * sizeof(ptopk->heap[0]));
+  if (ptopk->heap == NULL)
+  {
+    free(ptopk);
+    return NULL;
+  }
+  COUNT_ALLOC();
+
+  ptopk->k = k;
+  ptopk->n = 0;
+  ptopk->ob = 0;
+
+  return ptopk;
+}
+
+/**
+ * Frees a top-k accumulator
+ * @param ptopk pointer to the accumulator
+ */
+void topk_free(PTOPK ptopk)
+{
+  if (ptopk == NULL)
+    return;
+
+  free(ptopk->heap);
+  free(ptopk);
+}
+
+/**
+ * Adds a chunk of elements to a top-k accumulator. The first k elements
+ * fill the heap, which is built when it gets full; after that every
+ * element smaller than the root replaces it
+ * @param ptopk pointer to the accumulator
+ * @param chunk pointer to the elements
+ * @param n number of elements of the chunk
+ * @return Number of basic operations performed
+ *         ERR in case of error
+ */
+long topk_push(PTOPK ptopk, const int *chunk, long n)
+{
+  long i, j, ob = 0;
+
+  if (ptopk == NULL || (chunk == NULL && n > 0) || n < 0)
+    return ERR;
+
+  for (i = 0; i < n && ptopk->n < ptopk->k; i++)
+  {
+    ptopk->heap[ptopk->n++] = chunk[i];
+    COUNT_MOVE(1);
+
+    /* Heap lleno: lo construimos */
+    if (ptopk->n == ptopk->k)
+    {
+      for (j = ptopk->k / 2 - 1; j >= 0; j--)
+        ob += heapify(ptopk->heap, 0, ptopk->k, j);
+    }
+  }
+
+  for (; i < n; i++)
+  {
+    if (OB(ob) && chunk[i] < ptopk->heap[0])
+    {
+      ptopk->heap[0] = chunk[i];
+      COUNT_MOVE(1);
+      ob += heapify(ptopk->heap, 0, ptopk->k, 0);
+    }
+  }
+
+  ptopk->ob += ob;
+
+  return ob;
+}
+
+/**
+ * Copies to out, in ascending order, the smallest elements seen by a 
+ * top-k accumulator: k of them, or all if fewer were pushed
+ * @param ptopk pointer to the accumulator
+ * @param out array of at least k elements
+ * @param n_out pointer where the number of elements copied is stored
+ * @return Number of basic operations performed
+ *         ERR in case of error
+ */
+long topk_result(PTOPK ptopk, int *out, long *n_out)
+{
+  long i, ob = 0;
+
+  if (ptopk == NULL || out == NULL || n_out == NULL)
+    return ERR;
+
+  for (i = 0; i < ptopk->n; i++)
+    out[i] = ptopk->heap[i];
+  COUNT_MOVE(ptopk->n);
+
+  *n_out = ptopk->n;
+  if (ptopk->n > 1)
+    ob += HeapSort64(out, 0, ptopk->n - 1);
+
+  ptopk->ob += ob;
+
+  return ob;
+}
+
+/**
+ * Puts tabla[a] and tabla[b] in order
+ * @param tabla pointer to an array of integers
+ * @param a index of the first element
+ * @param b index of the second element
+ * @return Number of basic operations performed
+ */
+static long pdq_sort2(int *tabla, long a, long b)
+{
+  long ob = 0;
+
+  if (OB(ob) && tabla[b] < tabla[a])
+    SWAP(&tabla[a], &tabla[b]);
+
+  return ob;
+}
+
+/**
+ * Puts tabla[a], tabla[b] and tabla[c] in order
+ * @param tabla pointer to an array of integers
+ * @param a index of the first element
+ * @param b index of the second element
+ * @param c index of the third element
+ * @return Number of basic operations performed
+ */
+static long pdq_sort3(int *tabla, long a, long b, long c)
+{
+  long ob = 0;
+
+  ob += pdq_sort2(tabla, a, b);
+  ob += pdq_sort2(tabla, b, c);
+  ob += pdq_sort2(tabla, a, b);
+
+  return ob;
+}
+
+/**
+ * Insertion sort that gives up once it has moved more than limit 
+ * elements. Used on partitions that look sorted
+ * @param tabla pointer to an array of integers
+ * @param ip first index of the array
+ * @param iu last index of the array
+ * @param limit maximum number of elements moved
+ * @param sorted pointer where 1 is stored if the range got sorted, 0 if not
+ * @return Number of basic operations performed
+ */
+static long pdq_partial_insertion(int *tabla, long ip, long iu, long limit, int *sorted)
+{
+  long i, j, moved = 0, ob = 0;
+  int ele;
+
+  *sorted = 0;
+  for (i = ip + 1; i <= iu; i++)
+  {
+    if (moved > limit)
+      return ob;
+
+    if (OB(ob) && tabla[i] < tabla[i - 1])
+    {
+      ele = tabla[i];
+      for (j = i - 1; j >= ip && (j == i - 1 || (OB(ob) && ele < tabla[j])); j--)
+        tabla[j + 1] = tabla[j];
+      tabla[j + 1] = ele;
+      COUNT_MOVE(i - j);
+      moved += i - j - 1;
+    }
+  }
+
+  *sorted = 1;
+  return ob;
+}
+
+/**
+ * Partition of pdqsort around the pivot tabla[ip]: the elements smaller 
+ * than the pivot go to its left and the rest to its right. The range
+ * must have an element not smaller than the pivot at iu
+ * @param tabla pointer to an array of integers
+ * @param ip first index of the array
+ * @param iu last index of the array
+ * @param pos pointer where the final index of the pivot is stored
+ * @param partitioned pointer where 1 is stored if no element was swapped
+ * @return Number of basic operations performed
+ */
+static long pdq_partition_right(int *tabla, long ip, long iu, long *pos, int *partitioned)
+{
+  long first = ip, last = iu + 1, ob = 0;
+  int pivot = tabla[ip];
+
+  /* Buscamos el primer par mal colocado */
+  while (OB(ob) && tabla[++first] < pivot)
+    ;
+  if (first - 1 == ip)
+  {
+    while (first < last && !(OB(ob) && tabla[--last] < pivot))
+      ;
+  }
+  else
+  {
+    while (!(OB(ob) && tabla[--last] < pivot))
+      ;
+  }
+
+  *partitioned = first >= last;
+
+  while (first < last)
+  {
+    SWAP(&tabla[first], &tabla[last]);
+    while (OB(ob) && tabla[++first] < pivot)
+      ;
+    while (!(OB(ob) && tabla[--last] < pivot))
+      ;
+  }
+
+  /* Colocamos el pivote */
+  *pos = first - 1;
+  tabla[ip] = tabla[*pos];
+  tabla[*pos] = pivot;
+  COUNT_MOVE(2);
+
+  return ob;
+}
+
+/**
+ * Partition of pdqsort that puts the elements equal to the pivot tabla[ip]
+ * on its left. It is used when the pivot equals the one of the parent 
+ * partition, so that all the equal elements are placed in one step
+ * @param tabla pointer to an array of integers
+ * @param ip first index of the array
+ * @param iu last index of the array
+ * @param pos pointer where the final index of the pivot is stored
+ * @return Number of basic operations performed
+ */
+static long pdq_partition_left(int *tabla, long ip, long iu, long *pos)
+{
+  long first = ip, last = iu + 1, ob = 0;
+  int pivot = tabla[ip];
+
+  while (OB(ob) && pivot < tabla[--last])
+    ;
+  if (last == iu)
+  {
+    while (first < last && !(OB(ob) && pivot < tabla[++first]))
+      ;
+  }
+  else
+  {
+    while (!(OB(ob) && pivot < tabla[++first]))
+      ;
+  }
+
+  while (first < last)
+  {
+    SWAP(&tabla[first], &tabla[last]);
+    while (OB(ob) && pivot < tabla[--last])
+      ;
+    while (!(OB(ob) && pivot < tabla[++first]))
+      ;
+  }
+
+  *pos = last;
+  tabla[ip] = tabla[*pos];
+  tabla[*pos] = pivot;
+  COUNT_MOVE(2);
+
+  return ob;
+}
+
+/**
+ * Main loop of pdqsort. Recurses on the left partition and iterates on
+ * the right one
+ * @param tabla pointer to an array of integers
+ * @param ip first index of the array
+ * @param iu last index of the array
+ * @param bad_allowed unbalanced partitions left before falling back to heapsort
+ * @param leftmost 1 if there is no element of a previous pivot at ip - 1
+ * @return Number of basic operations performed
+ */
+static long pdq_loop(int *tabla, long ip, long iu, int bad_allowed, int leftmost)
+{
+  long size, half, pos, l_size, r_size, ob = 0;
+  int partitioned, sorted;
+
+  while (1)
+  {
+    size = iu - ip + 1;
+
+    /* Rangos pequeños con red de ordenación o por inserción */
+    if (size <= 1)
+      return ob;
+    if (size - 1 < sort_base_case)
+      return ob + network_sort(tabla, ip, iu);
+    if (size < PDQ_INSERTION)
+      return ob + InsertSort64(tabla, ip, iu);
+
+    /* Pivote: mediana de tres o pseudomediana de nueve, queda en ip */
+    half = size / 2;
+    if (size > PDQ_NINTHER)
+    {
+      ob += pdq_sort3(tabla, ip, ip + half, iu);
+      ob += pdq_sort3(tabla, ip + 1, ip + half - 1, iu - 1);
+      ob += pdq_sort3(tabla, ip + 2, ip + half + 1, iu - 2);
+      ob += pdq_sort3(tabla, ip + half - 1, ip + half, ip + half + 1);
+      SWAP(&tabla[ip], &tabla[ip + half]);
+    }
+    else
+    {
+      ob += pdq_sort3(tabla, ip + half, ip, iu);
+    }
+
+    /* Pivote igual al anterior: los iguales se colocan de una vez */
+    if (!leftmost && !(OB(ob) && tabla[ip - 1] < tabla[ip]))
+    {
+      ob += pdq_partition_left(tabla, ip, iu, &pos);
+      ip = pos + 1;
+      continue;
+    }
+
+    ob += pdq_partition_right(tabla, ip, iu, &pos, &partitioned);
+
+    l_size = pos - ip;
+    r_size = iu - pos;
+
+    if (l_size < size / 8 || r_size < size / 8)
+    {
+      /* Partición mala: tras log2(N) acotamos con heapsort */
+      if (--bad_allowed == 0)
+        return ob + HeapSort64(tabla, ip, iu);
+
+      /* Rompemos patrones con intercambios deterministas */
+      if (l_size >= PDQ_INSERTION)
+      {
+        SWAP(&tabla[ip], &tabla[ip + l_size / 4]);
+        SWAP(&tabla[pos - 1], &tabla[pos - l_size / 4]);
+        if (l_size > PDQ_NINTHER)
+        {
+          SWAP(&tabla[ip + 1], &tabla[ip + l_size / 4 + 1]);
+          SWAP(&tabla[ip + 2], &tabla[ip + l_size / 4 + 2]);
+          SWAP(&tabla[pos - 2], &tabla[pos - l_size / 4 - 1]);
+          SWAP(&tabla[pos - 3], &tabla[pos - l_size / 4 - 2]);
+        }
+      }
+      if (r_size >= PDQ_INSERTION)
+      {
+        SWAP(&tabla[pos + 1], &tabla[pos + 1 + r_size / 4]);
+        SWAP(&tabla[iu], &tabla[iu - r_size / 4]);
+        if (r_size > PDQ_NINTHER)
+        {
+          SWAP(&tabla[pos + 2], &tabla[pos + 2 + r_size / 4]);
+          SWAP(&tabla[pos + 3], &tabla[pos + 3 + r_size / 4]);
+          SWAP(&tabla[iu - 1], &tabla[iu - 1 - r_size / 4]);
+          SWAP(&tabla[iu - 2], &tabla[iu - 2 - r_size / 4]);
+        }
+      }
+    }
+    else if (partitioned)
+    {
+      /* Partición sin intercambios: probablemente ya está ordenado */
+      ob += pdq_partial_insertion(tabla, ip, pos - 1, PDQ_PARTIAL_LIMIT, &sorted);
+      if (sorted)
+      {
+        ob += pdq_partial_insertion(tabla, pos + 1, iu, PDQ_PARTIAL_LIMIT, &sorted);
+        if (sorted)
+          return ob;
+      }
+    }
+
+    ob += pdq_loop(tabla, ip, pos - 1, bad_allowed, leftmost);
+    ip = pos + 1;
+    leftmost = 0;
+  }
+}
+
+/**
+ * Pattern-defeating quicksort. Quicksort with median of three (ninther for
+ * big ranges) that detects unbalanced partitions and breaks their patterns
+ * with deterministic swaps, tries insertion sort on partitions that look 
+ * already sorted, puts the runs of a repeated pivot in place at once and
+ * bounds the worst case with heapsort after log2(N) bad partitions
+ * @param tabla pointer to an array of integers
+ * @param ip first index of the array
+ * @param iu last index of the array
+ * @return Number of basic operations performed by the algorithm
+ */
+long pdqsort64(int *tabla, long ip, long iu)
+{
+  long n;
+  int bad_allowed = 0;
+  /* Control de errores */
+  assert(tabla != NULL);
+  assert(ip >= 0);
+  assert(iu >= ip);
+
+  for (n = iu - ip + 1; n > 1; n >>= 1)
+    bad_allowed++;
+
+  return pdq_loop(tabla, ip, iu, bad_allowed, 1);
+}
+
+/**
+ * Merges bottom-up with merge the n_runs ascending runs of the array
+ * @param tabla pointer to an array of integers
+ * @param ip first index of the array
+ * @param iu last index of the array
+ * @param n_runs number of ascending runs of the array
+ * @return Number of basic operations performed by the algorithm
+ *         ERR in case of error
+ */
+static long merge_runs(int *tabla, long ip, long iu, long n_runs)
+{
+  long *runs = NULL, i, j, r, ob = 0;
+
+  /* runs[r] guarda el primer índice del tramo r, runs[n_runs] = iu + 1 */
+  runs = (long *)malloc(sizeof(runs[0]) * (n_runs + 1));
+  if (runs == NULL)
+    return ERR;
+  COUNT_ALLOC();
+
+  r = 0;
+  runs[r++] = ip;
+  for (i = ip + 1; i <= iu && r < n_runs; i++)
+  {
+    if (OB(ob) && tabla[i] < tabla[i - 1])
+      runs[r++] = i;
+  }
+  runs[n_runs] = iu + 1;
+
+  /* Mezclamos tramos adyacentes dos a dos hasta que queda uno */
+  while (n_runs > 1)
+  {
+    for (i = 0, j = 0; i + 1 < n_runs; i += 2, j++)
+    {
+      ob += merge64(tabla, runs[i], runs[i + 2] - 1, runs[i + 1] - 1);
+      runs[j] = runs[i];
+    }
+    if (i < n_runs)
+      runs[j++] = runs[i];
+    runs[j] = iu + 1;
+    n_runs = j;
+  }
+
+  free(runs);
+  return ob;
+}
+
+/**
+ * Mergesort that takes advantage of the ascending runs already present in
+ * the array: it counts them, so their starts take n_runs + 1 longs, and
+ * merges them bottom-up with merge
+ * @param tabla pointer to an array of integers
+ * @param ip first index of the array
+ * @param iu last index of the array
+ * @return Number of basic operations performed by the algorithm
+ *         ERR in case of error
+ */
+long natural_mergesort64(int *tabla, long ip, long iu)
+{
+  long n_runs = 1, i, st, ob = 0;
+  /* Control de errores */
+  assert(tabla != NULL);
+  assert(ip >= 0);
+  assert(iu >= ip);
+
+  for (i = ip + 1; i <= iu; i++)
+  {
+    if (OB(ob) && tabla[i] < tabla[i - 1])
+      n_runs++;
+  }
+
+  st = merge_runs(tabla, ip, iu, n_runs);
+  if (st == ERR)
+    return ERR;
+
+  return ob + st;
+}
+
+/**
+ * Finds the minimum and maximum values of the array in one pass
+ * @param tabla pointer to an array of integers
+ * @param ip first index of the array
+ * @param iu last index of the array
+ * @param pmin pointer where the minimum is stored
+ * @param pmax pointer where the maximum is stored
+ */
+static void min_max(int *tabla, long ip, long iu, int *pmin, int *pmax)
+{
+  long i;
+
+  *pmin = *pmax = tabla[ip];
+  for (i = ip + 1; i <= iu; i++)
+  {
+    if (tabla[i] < *pmin)
+      *pmin = tabla[i];
+    else if (tabla[i] > *pmax)
+      *pmax = tabla[i];
+  }
+}
+
+/**
+ * LSD radix sort by bytes of the key minus the minimum of the array, so the
+ * number of passes depends on the value range and not on the width of int
+ * @param tabla pointer to an array of integers
+ * @param ip first index of the array
+ * @param iu last index of the array
+ * @return Number of basic operations (key digits extracted)
+ *         ERR in case of error
+ */
+long radix_sort64(int *tabla, long ip, long iu)
+{
+  int *aux = NULL, *src, *dst, *tmp, minimum, maximum, shift;
+  long n, i, ob = 0;
+  unsigned int range;
+  long count[RADIX_BUCKETS + 1];
+  /* Control de errores */
+  assert(tabla != NULL);
+  assert(ip >= 0);
+  assert(iu >= ip);
+
+  n = iu - ip + 1;
+
+  min_max(tabla, ip, iu, &minimum, &maximum);
+  range = (unsigned int)maximum - (unsigned int)minimum;
+
+  aux = (int *)malloc(sizeof(aux[0]) * n);
+  if (aux == NULL)
+    return ERR;
+  COUNT_ALLOC();
+
+  src = tabla + ip;
+  dst = aux;
+  for (shift = 0; shift < (int)(sizeof(int) * 8) && (range >> shift) != 0; shift += RADIX_BITS)
+  {
+    for (i = 0; i <= RADIX_BUCKETS; i++)
+      count[i] = 0;
+
+    /* Histograma del dígito actual */
+    for (i = 0; i < n; i++)
+    {
+      OB_INC(ob);
+      count[((((unsigned int)src[i] - (unsigned int)minimum) >> shift) & (RADIX_BUCKETS - 1)) + 1]++;
+    }
+
+    /* Sumas prefijas: posición inicial de cada cubeta */
+    for (i = 0; i < RADIX_BUCKETS; i++)
+      count[i + 1] += count[i];
+
+    for (i = 0; i < n; i++)
+      dst[count[(((unsigned int)src[i] - (unsigned int)minimum) >> shift) & (RADIX_BUCKETS - 1)]++] = src[i];
+    COUNT_MOVE(n);
+
+    tmp = src;
+    src = dst;
+    dst = tmp;
+  }
+
+  /* Si el resultado quedó en la tabla auxiliar lo copiamos */
+  if (src != tabla + ip)
+  {
+    for (i = 0; i < n; i++)
+      tabla[ip + i] = src[i];
+    COUNT_MOVE(n);
+  }
+
+  free(aux);
+  return ob;
+}
+
+/**
+ * Recursive step of american_flag_sort: permutes the range into the
+ * buckets of the digit at shift following the cycles of the permutation
+ * and sorts each bucket by the next digit
+ * @param tabla pointer to an array of integers
+ * @param ip first index of the array
+ * @param iu last index of the array
+ * @param minimum minimum value of the whole array, subtracted from the keys
+ * @param shift position of the digit
+ * @return Number of basic operations (key digits extracted)
+ */
+static long american_flag_rec(int *tabla, long ip, long iu, int minimum, int shift)
+{
+  long count[RADIX_BUCKETS], next[RADIX_BUCKETS], end[RADIX_BUCKETS], i, ob = 0;
+  int b, d, ele, tmp;
+
+  if (iu - ip + 1 <= AMERICAN_FLAG_SMALL)
+    return InsertSort64(tabla, ip, iu);
+
+  for (b = 0; b < RADIX_BUCKETS; b++)
+    count[b] = 0;
+
+  /* Histograma del dígito actual */
+  for (i = ip; i <= iu; i++)
+  {
+    OB_INC(ob);
+    count[(((unsigned int)tabla[i] - (unsigned int)minimum) >> shift) & (RADIX_BUCKETS - 1)]++;
+  }
+
+  /* Comienzo y fin de cada cubeta */
+  for (b = 0, i = ip; b < RADIX_BUCKETS; b++)
+  {
+    next[b] = i;
+    i += count[b];
+    end[b] = i;
+  }
+
+  /* Cada elemento va a su cubeta siguiendo el ciclo que lo desplaza */
+  for (b = 0; b < RADIX_BUCKETS; b++)
+  {
+    while (next[b] < end[b])
+    {
+      ele = tabla[next[b]];
+      OB_INC(ob);
+      d = (((unsigned int)ele - (unsigned int)minimum) >> shift) & (RADIX_BUCKETS - 1);
+      while (d != b)
+      {
+        tmp = tabla[next[d]];
+        tabla[next[d]++] = ele;
+        COUNT_MOVE(1);
+        ele = tmp;
+        OB_INC(ob);
+        d = (((unsigned int)ele - (unsigned int)minimum) >> shift) & (RADIX_BUCKETS - 1);
+      }
+      tabla[next[b]++] = ele;
+      COUNT_MOVE(1);
+    }
+  }
+
+  /* Ordenamos cada cubeta por el dígito siguiente */
+  if (shift > 0)
+  {
+    for (b = 0; b < RADIX_BUCKETS; b++)
+    {
+      if (count[b] > 1)
+        ob += american_flag_rec(tabla, end[b] - count[b], end[b] - 1, minimum, shift - RADIX_BITS);
+    }
+  }
+
+  return ob;
+}
+
+/**
+ * American flag sort: in-place MSD radix sort by bytes of the key minus
+ * the minimum of the array. Unlike radix_sort it needs no auxiliary table,
+ * only the bucket counters of each level of the recursion
+ * @param tabla pointer to an array of integers
+ * @param ip first index of the array
+ * @param iu last index of the array
+ * @return Number of basic operations (key digits extracted)
+ */
+long american_flag_sort64(int *tabla, long ip, long iu)
+{
+  int minimum, maximum, shift;
+  unsigned int range;
+  /* Control de errores */
+  assert(tabla != NULL);
+  assert(ip >= 0);
+  assert(iu >= ip);
+
+  min_max(tabla, ip, iu, &minimum, &maximum);
+  range = (unsigned int)maximum - (unsigned int)minimum;
+
+  /* Empezamos por el dígito más significativo del rango */
+  for (shift = 0; shift + RADIX_BITS < (int)(sizeof(int) * 8) && (range >> (shift + RADIX_BITS)) != 0; shift += RADIX_BITS)
+    ;
+
+  return american_flag_rec(tabla, ip, iu, minimum, shift);
+}
+
+/**
+ * LSD radix sort by bytes of unsigned keys. The passes where every key
+ * has the same digit are skipped
+ * @param keys keys to sort, where the result is left
+ * @param aux buffer of n keys
+ * @param n number of keys
+ * @param bytes number of significant bytes of the keys
+ * @return Number of basic operations (key digits extracted)
+ */
+static long radix_keys(unsigned long *keys, unsigned long *aux, long n, int bytes)
+{
+  unsigned long *src = keys, *dst = aux, *tmp;
+  long count[RADIX_BUCKETS + 1], i, ob = 0;
+  int shift, b;
+
+  for (shift = 0; shift < bytes * 8; shift += RADIX_BITS)
+  {
+    for (b = 0; b <= RADIX_BUCKETS; b++)
+      count[b] = 0;
+
+    /* Histograma del dígito actual */
+    for (i = 0; i < n; i++)
+    {
+      OB_INC(ob);
+      count[((src[i] >> shift) & (RADIX_BUCKETS - 1)) + 1]++;
+    }
+
+    /* Todas las claves en la misma cubeta: la pasada no cambia nada */
+    for (b = 1; b <= RADIX_BUCKETS && count[b] != n; b++)
+      ;
+    if (b <= RADIX_BUCKETS)
+      continue;
+
+    for (b = 0; b < RADIX_BUCKETS; b++)
+      count[b + 1] += count[b];
+
+    for (i = 0; i < n; i++)
+      dst[count[(src[i] >> shift) & (RADIX_BUCKETS - 1)]++] = src[i];
+    COUNT_MOVE_WIDTH(n, sizeof(src[0]));
+
+    tmp = src;
+    src = dst;
+    dst = tmp;
+  }
+
+  if (src != keys)
+  {
+    for (i = 0; i < n; i++)
+      keys[i] = src[i];
+    COUNT_MOVE_WIDTH(n, sizeof(keys[0]));
+  }
+
+  return ob;
+}
+
+/**
+ * 32-bit version of radix_keys: LSD radix sort by bytes of the unsigned int
+ * keys of radix_sort_float, so the buffer is half the size of one of 
+ * unsigned long keys
+ * @param keys keys to sort, where the result is left
+ * @param aux buffer of n keys
+ * @param n number of keys
+ * @return Number of basic operations (key digits extracted)
+ */
+static long radix_keys32(unsigned int *keys, unsigned int *aux, long n)
+{
+  unsigned int *src = keys, *dst = aux, *tmp;
+  long count[RADIX_BUCKETS + 1], i, ob = 0;
+  int shift, b;
+
+  for (shift = 0; shift < (int)(sizeof(keys[0]) * 8); shift += RADIX_BITS)
+  {
+    for (b = 0; b <= RADIX_BUCKETS; b++)
+      count[b] = 0;
+
+    /* Histograma del dígito actual */
+    for (i = 0; i < n; i++)
+    {
+      OB_INC(ob);
+      count[((src[i] >> shift) & (RADIX_BUCKETS - 1)) + 1]++;
+    }
+
+    /* Todas las claves en la misma cubeta: la pasada no cambia nada */
+    for (b = 1; b <= RADIX_BUCKETS && count[b] != n; b++)
+      ;
+    if (b <= RADIX_BUCKETS)
+      continue;
+
+    for (b = 0; b < RADIX_BUCKETS; b++)
+      count[b + 1] += count[b];
+
+    for (i = 0; i < n; i++)
+      dst[count[(src[i] >> shift) & (RADIX_BUCKETS - 1)]++] = src[i];
+    COUNT_MOVE_WIDTH(n, sizeof(src[0]));
+
+    tmp = src;
+    src = dst;
+    dst = tmp;
+  }
+
+  if (src != keys)
+  {
+    for (i = 0; i < n; i++)
+      keys[i] = src[i];
+    COUNT_MOVE_WIDTH(n, sizeof(keys[0]));
+  }
+
+  return ob;
+}
+
+/**
+ * Radix sort of doubles. The IEEE-754 bits of each value are mapped to an
+ * unsigned key with the same order: the sign bit is set in the positive 
+ * values and all the bits are inverted in the negative ones, so -0.0 goes
+ * before +0.0. The NaNs, which have no order, are moved to the end first
+ * @param tabla pointer to an array of doubles
+ * @param ip first index of the array
+ * @param iu last index of the array
+ * @return Number of basic operations (key digits extracted)
+ *         ERR in case of error, or if unsigned long cannot hold a double
+ */
+long radix_sort_double(double *tabla, long ip, long iu)
+{
+  unsigned long *keys = NULL, sign;
+  long i, last, n, ob;
+  double tmp;
+  /* Control de errores */
+  assert(tabla != NULL);
+  assert(ip >= 0);
+  assert(iu >= ip);
+
+  if (sizeof(unsigned long) != sizeof(double))
+    return ERR;
+
+  /* Los NaN (x != x) al final */
+  for (i = ip, last = iu; i <= last;)
+  {
+    if (tabla[i] != tabla[i])
+    {
+      tmp = tabla[i];
+      tabla[i] = tabla[last];
+      tabla[last--] = tmp;
+      COUNT_MOVE_WIDTH(2, sizeof(tmp));
+    }
+    else
+      i++;
+  }
+
+  n = last - ip + 1;
+  if (n < 2)
+    return 0;
+
+  keys = (unsigned long *)malloc(sizeof(keys[0]) * 2 * n);
+  if (keys == NULL)
+    return ERR;
+  COUNT_ALLOC();
+
+  sign = 1UL << (sizeof(keys[0]) * 8 - 1);
+  for (i = 0; i < n; i++)
+  {
+    memcpy(&keys[i], &tabla[ip + i], sizeof(keys[0]));
+    keys[i] = (keys[i] & sign) ? ~keys[i] : keys[i] | sign;
+  }
+
+  ob = radix_keys(keys, keys + n, n, sizeof(double));
+
+  /* Transformación inversa */
+  for (i = 0; i < n; i++)
+  {
+    keys[i] = (keys[i] & sign) ? keys[i] & ~sign : ~keys[i];
+    memcpy(&tabla[ip + i], &keys[i], sizeof(keys[0]));
+  }
+  COUNT_MOVE_WIDTH(n, sizeof(tabla[0]));
+
+  free(keys);
+  return ob;
+}
+
+/**
+ * Radix sort of floats, with the same mapping of the bits as 
+ * radix_sort_double on 32-bit keys
+ * @param tabla pointer to an array of floats
+ * @param ip first index of the array
+ * @param iu last index of the array
+ * @return Number of basic operations (key digits extracted)
+ *         ERR in case of error, or if unsigned int is not as wide as a float
+ */
+long radix_sort_float(float *tabla, long ip, long iu)
+{
+  unsigned int *keys = NULL, bits, sign;
+  long i, last, n, ob;
+  float tmp;
+  /* Control de errores */
+  assert(tabla != NULL);
+  assert(ip >= 0);
+  assert(iu >= ip);
+
+  if (sizeof(unsigned int) != sizeof(float))
+    return ERR;
+
+  /* Los NaN (x != x) al final */
+  for (i = ip, last = iu; i <= last;)
+  {
+    if (tabla[i] != tabla[i])
+    {
+      tmp = tabla[i];
+      tabla[i] = tabla[last];
+      tabla[last--] = tmp;
+      COUNT_MOVE_WIDTH(2, sizeof(tmp));
+    }
+    else
+      i++;
+  }
+
+  n = last - ip + 1;
+  if (n < 2)
+    return 0;
+
+  keys = (unsigned int *)malloc(sizeof(keys[0]) * 2 * n);
+  if (keys == NULL)
+    return ERR;
+  COUNT_ALLOC();
+
+  sign = 1U << (sizeof(bits) * 8 - 1);
+  for (i = 0; i < n; i++)
+  {
+    memcpy(&bits, &tabla[ip + i], sizeof(bits));
+    keys[i] = (bits & sign) ? ~bits : bits | sign;
+  }
+
+  ob = radix_keys32(keys, keys + n, n);
+
+  /* Transformación inversa */
+  for (i = 0; i < n; i++)
+  {
+    bits = (keys[i] & sign) ? keys[i] & ~sign : ~keys[i];
+    memcpy(&tabla[ip + i], &bits, sizeof(bits));
+  }
+  COUNT_MOVE_WIDTH(n, sizeof(tabla[0]));
+
+  free(keys);
+  return ob;
+}
+
+/**
+ * Counting sort for arrays whose values lie in [minimum, maximum]. Counts
+ * the occurrences of each value and rewrites the array in O(N + range)
+ * @param tabla pointer to an array of integers
+ * @param ip first index of the array
+ * @param iu last index of the array
+ * @param minimum minimum value of the array
+ * @param maximum maximum value of the array
+ * @return Number of basic operations (elements counted and written)
+ *         ERR in case of error
+ */
+long counting_sort_range64(int *tabla, long ip, long iu, int minimum, int maximum)
+{
+  long *count = NULL, i, ob = 0;
+  unsigned int range, k;
+  /* Control de errores */
+  assert(tabla != NULL);
+  assert(ip >= 0);
+  assert(iu >= ip);
+  assert(minimum <= maximum);
+
+  range = (unsigned int)maximum - (unsigned int)minimum;
+
+  count = (long *)calloc((size_t)range + 1, sizeof(count[0]));
+  if (count == NULL)
+    return ERR;
+  COUNT_ALLOC();
+
+  for (i = ip; i <= iu; i++)
+  {
+    OB_INC(ob);
+    count[(unsigned int)tabla[i] - (unsigned int)minimum]++;
+  }
+
+  /* Reescribimos la tabla en orden */
+  for (k = 0, i = ip; k <= range; k++)
+  {
+    for (; count[k] > 0; count[k]--, i++)
+    {
+      OB_INC(ob);
+      tabla[i] = (int)((unsigned int)minimum + k);
+    }
+    /* k == UINT_MAX: el rango cubre todos los int */
+    if (k == range)
+      break;
+  }
+  COUNT_MOVE(iu - ip + 1);
+
+  free(count);
+  return ob;
+}
+
+/**
+ * Counting sort. Detects the value range in one pass and sorts in 
+ * O(N + range) when the range is at most COUNTING_RANGE_FACTOR * N, otherwise
+ * the array is sorted with introsort
+ * @param tabla pointer to an array of integers
+ * @param ip first index of the array
+ * @param iu last index of the array
+ * @return Number of basic operations performed by the algorithm
+ *         ERR in case of error
+ */
+long counting_sort64(int *tabla, long ip, long iu)
+{
+  int minimum, maximum;
+  /* Control de errores */
+  assert(tabla != NULL);
+  assert(ip >= 0);
+  assert(iu >= ip);
+
+  min_max(tabla, ip, iu, &minimum, &maximum);
+
+  if ((double)maximum - (double)minimum >= COUNTING_RANGE_FACTOR * (double)(iu - ip + 1))
+    return introsort64(tabla, ip, iu);
+
+  return counting_sort_range64(tabla, ip, iu, minimum, maximum);
+}
+
+/**
+ * In-place sort for permutations of consecutive values (like the ones given
+ * by generate_perm). Every element is moved to position value - minimum 
+ * following the cycles of the permutation, with no extra memory. If the 
+ * values are not a permutation the array is sorted with counting_sort
+ * @param tabla pointer to an array of integers
+ * @param ip first index of the array
+ * @param iu last index of the array
+ * @return Number of basic operations performed by the algorithm
+ *         ERR in case of error
+ */
+long placement_sort64(int *tabla, long ip, long iu)
+{
+  int minimum, maximum;
+  long i, dest, ob = 0;
+  /* Control de errores */
+  assert(tabla != NULL);
+  assert(ip >= 0);
+  assert(iu >= ip);
+
+  min_max(tabla, ip, iu, &minimum, &maximum);
+
+  /* Sólo puede ser permutación si el rango coincide con N */
+  if ((double)maximum - (double)minimum != (double)(iu - ip))
+    return counting_sort64(tabla, ip, iu);
+
+  for (i = ip; i <= iu; i++)
+  {
+    /* Recorremos el ciclo que pasa por i */
+    while (OB_CHECK(ob) && (dest = ip + ((long)tabla[i] - minimum)) != i)
+    {
+      /* Valor repetido: no es una permutación */
+      if (tabla[dest] == tabla[i])
+        return ob + counting_sort_range64(tabla, ip, iu, minimum, maximum);
+
+      SWAP(&tabla[i], &tabla[dest]);
+    }
+  }
+
+  return ob;
+}
+
+/**
+ * Sorts keys narrowed to 8 bits: counts the occurrences of each of the 
+ * 256 values and rewrites the buffer in order
+ * @param a keys narrowed to 8 bits
+ * @param n number of keys
+ * @return Number of basic operations (keys counted)
+ */
+static long narrow_kernel_u8(unsigned char *a, long n)
+{
+  long count[NARROW_U8_RANGE], i, ob = 0;
+  int k;
+
+  for (k = 0; k < NARROW_U8_RANGE; k++)
+    count[k] = 0;
+
+  for (i = 0; i < n; i++)
+  {
+    OB_INC(ob);
+    count[a[i]]++;
+  }
+
+  for (k = 0, i = 0; k < NARROW_U8_RANGE; k++)
+  {
+    for (; count[k] > 0; count[k]--)
+      a[i++] = (unsigned char)k;
+  }
+  COUNT_MOVE_WIDTH(n, sizeof(a[0]));
+
+  return ob;
+}
+
+/**
+ * LSD radix sort of keys narrowed to 16 bits, one pass per byte. Each pass
+ * moves 2 bytes per key instead of the 4 of radix_sort
+ * @param a keys narrowed to 16 bits, where the result is left
+ * @param aux buffer of n keys
+ * @param n number of keys
+ * @return Number of basic operations (key digits extracted)
+ */
+static long narrow_kernel_u16(unsigned short *a, unsigned short *aux, long n)
+{
+  unsigned short *src = a, *dst = aux, *tmp;
+  long count[RADIX_BUCKETS + 1], i, ob = 0;
+  int shift;
+
+  for (shift = 0; shift < (int)(sizeof(a[0]) * 8); shift += RADIX_BITS)
+  {
+    for (i = 0; i <= RADIX_BUCKETS; i++)
+      count[i] = 0;
+
+    /* Histograma del dígito actual */
+    for (i = 0; i < n; i++)
+    {
+      OB_INC(ob);
+      count[((src[i] >> shift) & (RADIX_BUCKETS - 1)) + 1]++;
+    }
+
+    /* Sumas prefijas: posición inicial de cada cubeta */
+    for (i = 0; i < RADIX_BUCKETS; i++)
+      count[i + 1] += count[i];
+
+    for (i = 0; i < n; i++)
+      dst[count[(src[i] >> shift) & (RADIX_BUCKETS - 1)]++] = src[i];
+    COUNT_MOVE_WIDTH(n, sizeof(src[0]));
+
+    tmp = src;
+    src = dst;
+    dst = tmp;
+  }
+
+  /* Número impar de pasadas: el resultado quedó en aux */
+  if (src != a)
+  {
+    for (i = 0; i < n; i++)
+      a[i] = src[i];
+    COUNT_MOVE_WIDTH(n, sizeof(a[0]));
+  }
+
+  return ob;
+}
+
+/**
+ * Sort front end for small value ranges. If the range fits in 8 or 16 bits
+ * the keys minus the minimum are narrowed into a compact buffer, sorted 
+ * there with the kernel of that width and widened back, so the kernel
+ * moves 1 or 2 bytes per key instead of 4. Wider ranges are sorted with
+ * introsort
+ * @param tabla pointer to an array of integers
+ * @param ip first index of the array
+ * @param iu last index of the array
+ * @return Number of basic operations performed by the algorithm
+ *         ERR in case of error
+ */
+long narrow_sort64(int *tabla, long ip, long iu)
+{
+  unsigned char *b8 = NULL;
+  unsigned short *b16 = NULL;
+  int minimum, maximum;
+  unsigned int range;
+  long n, i, ob;
+  /* Control de errores */
+  assert(tabla != NULL);
+  assert(ip >= 0);
+  assert(iu >= ip);
+
+  n = iu - ip + 1;
+
+  min_max(tabla, ip, iu, &minimum, &maximum);
+  range = (unsigned int)maximum - (unsigned int)minimum;
+
+  if (range < NARROW_U8_RANGE)
+  {
+    b8 = (unsigned char *)malloc(sizeof(b8[0]) * n);
+    if (b8 == NULL)
+      return ERR;
+    COUNT_ALLOC();
+
+    /* Estrechamos, ordenamos y ensanchamos */
+    for (i = 0; i < n; i++)
+      b8[i] = (unsigned char)((unsigned int)tabla[ip + i] - (unsigned int)minimum);
+    COUNT_MOVE_WIDTH(n, sizeof(b8[0]));
+
+    ob = narrow_kernel_u8(b8, n);
+
+    for (i = 0; i < n; i++)
+      tabla[ip + i] = (int)((unsigned int)minimum + b8[i]);
+    COUNT_MOVE(n);
+
+    free(b8);
+    return ob;
+  }
+
+  if (range < NARROW_U16_RANGE)
+  {
+    /* Claves y tabla auxiliar del kernel en una sola reserva */
+    b16 = (unsigned short *)malloc(sizeof(b16[0]) * 2 * n);
+    if (b16 == NULL)
+      return ERR;
+    COUNT_ALLOC();
+
+    for (i = 0; i < n; i++)
+      b16[i] = (unsigned short)((unsigned int)tabla[ip + i] - (unsigned int)minimum);
+    COUNT_MOVE_WIDTH(n, sizeof(b16[0]));
+
+    ob = narrow_kernel_u16(b16, b16 + n, n);
+
+    for (i = 0; i < n; i++)
+      tabla[ip + i] = (int)((unsigned int)minimum + b16[i]);
+    COUNT_MOVE(n);
+
+    free(b16);
+    return ob;
+  }
+
+  return introsort64(tabla, ip, iu);
+}
+
+/**
+ * Measures the statistics used by adaptive_sort. The ascending runs and the
+ * value range are taken in one full pass, inversions and duplicates are
+ * estimated from ADAPTIVE_SAMPLE equally spaced elements
+ * @param tabla pointer to an array of integers
+ * @param ip first index of the array
+ * @param iu last index of the array
+ * @param pstats pointer to the struct where the statistics are stored
+ * @return Number of basic operations performed
+ */
+long sort_statistics64(int *tabla, long ip, long iu, PSORT_STATS pstats)
+{
+  int sample[ADAPTIVE_SAMPLE];
+  int j, s, inv = 0, dup = 0;
+  long i, n, ob = 0;
+  /* Control de errores */
+  assert(tabla != NULL);
+  assert(ip >= 0);
+  assert(iu >= ip);
+  assert(pstats != NULL);
+
+  n = iu - ip + 1;
+  pstats->N = n;
+  pstats->runs = 1;
+  pstats->minimum = pstats->maximum = tabla[ip];
+
+  /* Tramos ascendentes y rango en una pasada */
+  for (i = ip + 1; i <= iu; i++)
+  {
+    if (OB(ob) && tabla[i] < tabla[i - 1])
+      pstats->runs++;
+
+    if (tabla[i] < pstats->minimum)
+      pstats->minimum = tabla[i];
+    else if (tabla[i] > pstats->maximum)
+      pstats->maximum = tabla[i];
+  }
+  /* Un tramo por elemento: estrictamente descendente */
+  pstats->descending = (n > 1 && pstats->runs == n);
+
+  /* Muestra equiespaciada */
+  s = n < ADAPTIVE_SAMPLE ? n : ADAPTIVE_SAMPLE;
+  for (i = 0; i < s; i++)
+    sample[i] = tabla[ip + (long)((double)i * n / s)];
+  COUNT_MOVE(s);
+
+  /* Inversiones de la muestra */
+  for (i = 0; i < s; i++)
+  {
+    for (j = i + 1; j < s; j++)
+    {
+      if (OB(ob) && sample[j] < sample[i])
+        inv++;
+    }
+  }
+  pstats->inv_ratio = s > 1 ? inv / (s * (s - 1) / 2.0) : 0;
+
+  /* Duplicados: ordenamos la muestra y contamos vecinos iguales */
+  ob += InsertSort64(sample, 0, s - 1);
+  for (i = 1; i < s; i++)
+  {
+    if (OB(ob) && sample[i] == sample[i - 1])
+      dup++;
+  }
+  pstats->dup_ratio = s > 1 ? dup / (double)(s - 1) : 0;
+
+  return ob;
+}
+
+#ifndef NO_OB
+/**
+ * Sets the size up to which mergesort, quicksort and introsort sort their
+ * ranges with the generated sorting networks instead of recursing
+ * @param size biggest range sorted with a network, 1 to disable them
+ * @return OK
+ *         ERR if there is no network of that size
+ */
+int set_sort_base_case(int size)
+{
+  if (size < 1 || size > SORTNET_MAX)
+    return ERR;
+
+  sort_base_case = size;
+  return OK;
+}
+
+/**
+ * Selects the path used by merge. The AVX2 path is only accepted if the
+ * CPU supports it, otherwise the scalar path is kept
+ * @param path MERGE_SCALAR or MERGE_AVX2
+ * @return OK
+ *         ERR if the path is not supported
+ */
+int set_merge_path(int path)
+{
+  if (path == MERGE_SCALAR)
+  {
+    sort_merge_path = MERGE_SCALAR;
+    return OK;
+  }
+
+  if (path == MERGE_AVX2 && SIMD_AVX2 && CPU_HAS_AVX2())
+  {
+    sort_merge_path = MERGE_AVX2;
+    return OK;
+  }
+
+  return ERR;
+}
+
+/**
+ * Sets the size in bytes from which merge copies its result back with
+ * non-temporal stores, so the big merges do not evict the data that 
+ * is still reused from the cache
+ * @param bytes threshold in bytes, STREAM_AUTO for the size of the last 
+ *        level cache or STREAM_OFF to never stream
+ * @return OK
+ *         ERR if the threshold is not valid or the CPU has no streaming stores
+ */
+int set_stream_threshold(long bytes)
+{
+  if (bytes < 0 && bytes != STREAM_AUTO && bytes != STREAM_OFF)
+    return ERR;
+
+  if (bytes != STREAM_OFF && !(SIMD_SSE2 && CPU_HAS_SSE2()))
+    return ERR;
+
+  sort_stream_threshold = bytes;
+  return OK;
+}
+
+static const char *adaptive_engine_names[] = {
+    "none", "reverse", "insertion", "natural_merge", "placement", "counting",
+    "radix", "introsort"};
+
+/**
+ * Sets the stream where adaptive_sort writes one line for each decision 
+ * it takes. NULL disables the log. Only the counted variant writes it,
+ * so the timed runs do not include the writes
+ * @param pf stream opened by the caller
+ */
+void adaptive_sort_log(FILE *pf)
+{
+  adaptive_log = pf;
+}
+
+/**
+ * Returns the name of an adaptive_sort engine, as written in the log
+ * @param engine one of the ENGINE_* constants
+ * @return Name of the engine
+ */
+const char *adaptive_engine_name(int engine)
+{
+  assert(engine >= ENGINE_NONE && engine <= ENGINE_INTROSORT);
+
+  return adaptive_engine_names[engine];
+}
+
+/**
+ * Returns the uncounted variant (_nc) of a sorting function, to be
+ * timed while the ob are taken from the counted one
+ * @param method counted sorting function
+ * @return Uncounted variant of method, or method itself if it has none
+ */
+pfunc_sort uncounted_sort(pfunc_sort method)
+{
+  static const pfunc_sort counted[] = {
+      SelectSort, SelectSortInv, mergesort, quicksort, InsertSort, HeapSort,
+      introsort, natural_mergesort, radix_sort, counting_sort, placement_sort,
+      narrow_sort, pdqsort, american_flag_sort, adaptive_sort};
+  static const pfunc_sort uncounted[] = {
+      SelectSort_nc, SelectSortInv_nc, mergesort_nc, quicksort_nc, InsertSort_nc, HeapSort_nc,
+      introsort_nc, natural_mergesort_nc, radix_sort_nc, counting_sort_nc, placement_sort_nc,
+      narrow_sort_nc, pdqsort_nc, american_flag_sort_nc, adaptive_sort_nc};
+  int i;
+
+  for (i = 0; i < (int)(sizeof(counted) / sizeof(counted[0])); i++)
+  {
+    if (counted[i] == method)
+      return uncounted[i];
+  }
+
+  return method;
+}
+
+/**
+ * Returns the uncounted variant (_nc) of a 64-bit sorting function
+ * @param method counted sorting function
+ * @return Uncounted variant of method, or method itself if it has none
+ */
+pfunc_sort64 uncounted_sort64(pfunc_sort64 method)
+{
+  static const pfunc_sort64 counted[] = {
+      SelectSort64, SelectSortInv64, mergesort64, quicksort64, InsertSort64, HeapSort64,
+      introsort64, natural_mergesort64, radix_sort64, counting_sort64, placement_sort64,
+      narrow_sort64, pdqsort64, american_flag_sort64, adaptive_sort64};
+  static const pfunc_sort64 uncounted[] = {
+      SelectSort64_nc, SelectSortInv64_nc, mergesort64_nc, quicksort64_nc, InsertSort64_nc,
+      HeapSort64_nc, introsort64_nc, natural_mergesort64_nc, radix_sort64_nc, counting_sort64_nc,
+      placement_sort64_nc, narrow_sort64_nc, pdqsort64_nc, american_flag_sort64_nc,
+      adaptive_sort64_nc};
+  int i;
+
+  for (i = 0; i < (int)(sizeof(counted) / sizeof(counted[0])); i++)
+  {
+    if (counted[i] == method)
+      return uncounted[i];
+  }
+
+  return method;
+}
+
+/**
+ * Returns the uncounted variant (_nc) of a sorting function of doubles
+ * @param method counted sorting function
+ * @return Uncounted variant of method, or method itself if it has none
+ */
+pfunc_sort_double uncounted_sort_double(pfunc_sort_double method)
+{
+  if (method == radix_sort_double)
+    return radix_sort_double_nc;
+
+  return method;
+}
+
+/**
+ * Returns the 64-bit version of a sorting function of the int interface,
+ * counted or uncounted, so the callers of the int interface can work on
+ * arrays of any size
+ * @param method sorting function of the int interface
+ * @return 64-bit version of method, NULL if it has none
+ */
+pfunc_sort64 wide_sort(pfunc_sort method)
+{
+  static const pfunc_sort narrow[] = {
+      SelectSort, SelectSortInv, mergesort, quicksort, InsertSort, HeapSort,
+      introsort, natural_mergesort, radix_sort, counting_sort, placement_sort,
+      narrow_sort, pdqsort, american_flag_sort, adaptive_sort,
+      SelectSort_nc, SelectSortInv_nc, mergesort_nc, quicksort_nc, InsertSort_nc, HeapSort_nc,
+      introsort_nc, natural_mergesort_nc, radix_sort_nc, counting_sort_nc, placement_sort_nc,
+      narrow_sort_nc, pdqsort_nc, american_flag_sort_nc, adaptive_sort_nc};
+  static const pfunc_sort64 wide[] = {
+      SelectSort64, SelectSortInv64, mergesort64, quicksort64, InsertSort64, HeapSort64,
+      introsort64, natural_mergesort64, radix_sort64, counting_sort64, placement_sort64,
+      narrow_sort64, pdqsort64, american_flag_sort64, adaptive_sort64,
+      SelectSort64_nc, SelectSortInv64_nc, mergesort64_nc, quicksort64_nc, InsertSort64_nc,
+      HeapSort64_nc, introsort64_nc, natural_mergesort64_nc, radix_sort64_nc, counting_sort64_nc,
+      placement_sort64_nc, narrow_sort64_nc, pdqsort64_nc, american_flag_sort64_nc,
+      adaptive_sort64_nc};
+  int i;
+
+  for (i = 0; i < (int)(sizeof(narrow) / sizeof(narrow[0])); i++)
+  {
+    if (narrow[i] == method)
+      return wide[i];
+  }
+
+  return NULL;
+}
+
+/**
+ * Chooses the engine that adaptive_sort will use from the statistics
+ * of the input
+ * @param pstats pointer to the statistics of the array
+ * @return One of the ENGINE_* constants
+ */
+int adaptive_choose_engine(PSORT_STATS pstats)
+{
+  double range;
+
+  assert(pstats != NULL);
+
+  if (pstats->runs == 1)
+    return ENGINE_NONE;
+
+  if (pstats->descending)
+    return ENGINE_REVERSE;
+
+  if (pstats->N <= INTRO_SMALL)
+    return ENGINE_INSERTION;
+
+  /* Tramos largos de media: basta con mezclarlos */
+  if (pstats->runs <= pstats->N / ADAPTIVE_RUN_LENGTH)
+    return ENGINE_NATURAL_MERGE;
+
+  /* Tramos cortos pero casi sin inversiones en la muestra: el desorden es
+   * local y la inserción lo arregla moviendo pocos elementos */
+  if (pstats->inv_ratio <= ADAPTIVE_INV_RATIO)
+    return ENGINE_INSERTION;
+
+  /* Valores consecutivos sin repetidos en la muestra: posible permutación */
+  range = (double)pstats->maximum - (double)pstats->minimum;
+  if (range == pstats->N - 1 && pstats->dup_ratio == 0)
+    return ENGINE_PLACEMENT;
+
+  /* Rango denso: O(N + rango) con counting sort */
+  if (range < COUNTING_RANGE_FACTOR * (double)pstats->N)
+    return ENGINE_COUNTING;
+
+  /* Rango estrecho o muchos repetidos: pocas pasadas de radix */
+  if (range <= ADAPTIVE_RADIX_RANGE * (double)pstats->N || pstats->dup_ratio >= ADAPTIVE_DUP_RATIO)
+    return ENGINE_RADIX;
+
+  return ENGINE_INTROSORT;
+}
+#endif
+
+/**
+ * Sorting entry point that measures cheap statistics of the input 
+ * (runs, sampled inversions, duplicates and value range) and routes it to 
+ * the most suitable engine. Each decision is written to the stream set 
+ * with adaptive_sort_log
+ * @param tabla pointer to an array of integers
+ * @param ip first index of the array
+ * @param iu last index of the array
+ * @return Number of basic operations performed by the algorithm
+ *         ERR in case of error
+ */
+long adaptive_sort64(int *tabla, long ip, long iu)
+{
+  SORT_STATS stats;
+  long ob, st = 0, i;
+  int engine, sorted;
+  /* Control de errores */
+  assert(tabla != NULL);
+  assert(ip >= 0);
+  assert(iu >= ip);
+
+  ob = sort_statistics64(tabla, ip, iu, &stats);
+  engine = adaptive_choose_engine(&stats);
+
+#ifndef NO_OB
+  if (adaptive_log != NULL)
+  {
+    fprintf(adaptive_log, "%ld %ld %.4f %.4f %d %d %s\n", stats.N, stats.runs,
+            stats.inv_ratio, stats.dup_ratio, stats.minimum, stats.maximum,
+            adaptive_engine_names[engine]);
+  }
+#endif
+
+  switch (engine)
+  {
+  case ENGINE_NONE:
+    break;
+  case ENGINE_REVERSE:
+    for (i = 0; i < (iu - ip + 1) / 2; i++)
+      SWAP(&tabla[ip + i], &tabla[iu - i]);
+    break;
+  case ENGINE_INSERTION:
+    if (stats.N <= INTRO_SMALL)
+    {
+      st = InsertSort64(tabla, ip, iu);
+      break;
+    }
+
+    /* Si la muestra engaña y hay que mover demasiado, introsort termina */
+    st = pdq_partial_insertion(tabla, ip, iu, ADAPTIVE_INSERTION_MOVES * stats.N, &sorted);
+    if (!sorted)
+      st += introsort64(tabla, ip, iu);
+    break;
+  case ENGINE_NATURAL_MERGE:
+    /* La pasada de estadísticas ya contó los tramos */
+    st = merge_runs(tabla, ip, iu, stats.runs);
+    break;
+  case ENGINE_PLACEMENT:
+    st = placement_sort64(tabla, ip, iu);
+    break;
+  case ENGINE_COUNTING:
+    st = counting_sort_range64(tabla, ip, iu, stats.minimum, stats.maximum);
+    break;
+  case ENGINE_RADIX:
+    st = radix_sort64(tabla, ip, iu);
+    break;
+  default:
+    st = introsort64(tabla, ip, iu);
+    break;
+  }
+
+  if (st == ERR)
+    return ERR;
+
+  return ob + st;
+}
+
+/* int interface: thin wrappers over the 64-bit functions. The ob
+ * saturate at INT_MAX (see narrow_ob in ob.c) */
+
+int SelectSort(int *array, int ip, int iu)
+{
+  return narrow_ob(SelectSort64(array, ip, iu));
+}
+
+int SelectSortInv(int *array, int ip, int iu)
+{
+  return narrow_ob(SelectSortInv64(array, ip, iu));
+}
+
+int min(int *array, int ip, int iu, int *ob)
+{
+  long ob64 = *ob, pos;
+
+  pos = min64(array, ip, iu, &ob64);
+  *ob = narrow_ob(ob64);
+
+  return (int)pos;
+}
+
+int mergesort(int *tabla, int ip, int iu)
+{
+  return narrow_ob(mergesort64(tabla, ip, iu));
+}
+
+int merge(int *tabla, int ip, int iu, int imedio)
+{
+  return narrow_ob(merge64(tabla, ip, iu, imedio));
+}
+
+int quicksort(int *tabla, int ip, int iu)
+{
+  return narrow_ob(quicksort64(tabla, ip, iu));
+}
+
+int partition(int *tabla, int ip, int iu, int *pos)
+{
+  long pos64, ob;
+
+  ob = partition64(tabla, ip, iu, &pos64);
+  *pos = (int)pos64;
+
+  return narrow_ob(ob);
+}
+
+int median(int *tabla, int ip, int iu, int *pos)
+{
+  long pos64, ob;
+
+  ob = median64(tabla, ip, iu, &pos64);
+  *pos = (int)pos64;
+
+  return narrow_ob(ob);
+}
+
+int median_avg(int *tabla, int ip, int iu, int *pos)
+{
+  long pos64, ob;
+
+  ob = median_avg64(tabla, ip, iu, &pos64);
+  *pos = (int)pos64;
+
+  return narrow_ob(ob);
+}
+
+int median_stat(int *tabla, int ip, int iu, int *pos)
+{
+  long pos64, ob;
+
+  ob = median_stat64(tabla, ip, iu, &pos64);
+  *pos = (int)pos64;
+
+  return narrow_ob(ob);
+}
+
+int InsertSort(int *tabla, int ip, int iu)
+{
+  return narrow_ob(InsertSort64(tabla, ip, iu));
+}
+
+int HeapSort(int *tabla, int ip, int iu)
+{
+  return narrow_ob(HeapSort64(tabla, ip, iu));
+}
+
+int introsort(int *tabla, int ip, int iu)
+{
+  return narrow_ob(introsort64(tabla, ip, iu));
+}
+
+int partial_sort(int *tabla, int ip, int iu, int k)
+{
+  return narrow_ob(partial_sort64(tabla, ip, iu, k));
+}
+
+int pdqsort(int *tabla, int ip, int iu)
+{
+  return narrow_ob(pdqsort64(tabla, ip, iu));
+}
+
+int natural_mergesort(int *tabla, int ip, int iu)
+{
+  return narrow_ob(natural_mergesort64(tabla, ip, iu));
+}
+
+int radix_sort(int *tabla, int ip, int iu)
+{
+  return narrow_ob(radix_sort64(tabla, ip, iu));
+}
+
+int american_flag_sort(int *tabla, int ip, int iu)
+{
+  return narrow_ob(american_flag_sort64(tabla, ip, iu));
+}
+
+int counting_sort_range(int *tabla, int ip, int iu, int minimum, int maximum)
+{
+  return narrow_ob(counting_sort_range64(tabla, ip, iu, minimum, maximum));
+}
+
+int counting_sort(int *tabla, int ip, int iu)
+{
+  return narrow_ob(counting_sort64(tabla, ip, iu));
+}
+
+int placement_sort(int *tabla, int ip, int iu)
+{
+  return narrow_ob(placement_sort64(tabla, ip, iu));
+}
+
+int narrow_sort(int *tabla, int ip, int iu)
+{
+  return narrow_ob(narrow_sort64(tabla, ip, iu));
+}
+
+int sort_statistics(int *tabla, int ip, int iu, PSORT_STATS pstats)
+{
+  return narrow_ob(sort_statistics64(tabla, ip, iu, pstats));
+}
+
+int adaptive_sort(int *tabla, int ip, int iu)
+{
+  return narrow_ob(adaptive_sort64(tabla, ip, iu));
+}
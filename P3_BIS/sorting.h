@@ -12,6 +12,8 @@
 #ifndef SORTING_H
 #define SORTING_H
 
+#include <stdio.h>
+
 /* constants */
 
 #ifndef ERR
@@ -19,8 +21,142 @@
   #define OK (!(ERR))
 #endif
 
+/* merge paths */
+#define MERGE_SCALAR 0
+#define MERGE_AVX2 1
+#define MERGE_LANES 8 /* elements merged per step by the AVX2 path */
+#define BITONIC_MERGE_CMP 32 /* key comparisons of each step of the AVX2 path */
+
+/* merge copy-back with streaming stores: ranges of more bytes than the
+ * threshold skip the cache. STREAM_AUTO uses the size of the last level
+ * cache and STREAM_OFF never streams */
+#define STREAM_AUTO -1L
+#define STREAM_OFF -2L
+
+/* introsort: ranges of this size or smaller are sorted by insertion */
+#define INTRO_SMALL 16
+
+/* pdqsort: insertion sort size, size from which the pivot is the ninther
+ * and elements moved before a partial insertion sort gives up */
+#define PDQ_INSERTION 24
+#define PDQ_NINTHER 128
+#define PDQ_PARTIAL_LIMIT 8
+
+/* radix_sort: bits per pass and number of buckets */
+#define RADIX_BITS 8
+#define RADIX_BUCKETS (1 << RADIX_BITS)
+
+/* american_flag_sort: buckets of this size or smaller are sorted by insertion */
+#define AMERICAN_FLAG_SMALL 32
+
+/* counting_sort: maximum range / N to count instead of comparing */
+#define COUNTING_RANGE_FACTOR 4
+
+/* narrow_sort: value ranges whose keys fit in 8 and 16 bits */
+#define NARROW_U8_RANGE (1 << 8)
+#define NARROW_U16_RANGE (1 << 16)
+
+/* adaptive_sort: sample size and decision thresholds */
+#define ADAPTIVE_SAMPLE 64
+#define ADAPTIVE_RUN_LENGTH 32   /* minimum average run length to merge runs */
+#define ADAPTIVE_RADIX_RANGE 16  /* maximum range / N to use radix */
+#define ADAPTIVE_DUP_RATIO 0.5   /* minimum sampled duplicate ratio to use radix */
+#define ADAPTIVE_INV_RATIO 0.01  /* maximum sampled inversion ratio to use insertion */
+#define ADAPTIVE_INSERTION_MOVES 2 /* elements moved per element before insertion gives up */
+
+/* adaptive_sort engines */
+#define ENGINE_NONE 0
+#define ENGINE_REVERSE 1
+#define ENGINE_INSERTION 2
+#define ENGINE_NATURAL_MERGE 3
+#define ENGINE_PLACEMENT 4
+#define ENGINE_COUNTING 5
+#define ENGINE_RADIX 6
+#define ENGINE_INTROSORT 7
+
 /* type definitions */  
 typedef int (* pfunc_sort)(int*, int, int);
+/* 64-bit interface: sizes, indices and ob are long */
+typedef long (* pfunc_sort64)(int*, long, long);
+/* sorting of doubles, only with the 64-bit interface */
+typedef long (* pfunc_sort_double)(double*, long, long);
+
+typedef struct sort_stats {
+  long N;           /* number of elements */
+  long runs;        /* number of ascending runs */
+  int descending;   /* 1 if the array is strictly descending */
+  double inv_ratio; /* fraction of inverted pairs in the sample */
+  double dup_ratio; /* fraction of repeated neighbours in the sorted sample */
+  int minimum;      /* minimum value */
+  int maximum;      /* maximum value */
+} SORT_STATS, *PSORT_STATS;
+
+/* streaming top-k: max-heap with the k smallest elements seen */
+typedef struct topk {
+  int *heap;        /* heap, full once k elements have been pushed */
+  long k;           /* maximum number of elements kept */
+  long n;           /* elements in the heap */
+  long ob;          /* ob of all the pushes and results */
+} TOPK, *PTOPK;
+
+/* sorting.c compiled with -DNO_OB gives the uncounted variant of every
+ * algorithm, with the same name followed by _nc (see ob.h) */
+#ifdef NO_OB
+  #define SelectSort          SelectSort_nc
+  #define SelectSortInv       SelectSortInv_nc
+  #define min                 min_nc
+  #define mergesort           mergesort_nc
+  #define merge               merge_nc
+  #define quicksort           quicksort_nc
+  #define partition           partition_nc
+  #define median              median_nc
+  #define median_avg          median_avg_nc
+  #define median_stat         median_stat_nc
+  #define InsertSort          InsertSort_nc
+  #define HeapSort            HeapSort_nc
+  #define introsort           introsort_nc
+  #define partial_sort        partial_sort_nc
+  #define pdqsort             pdqsort_nc
+  #define natural_mergesort   natural_mergesort_nc
+  #define radix_sort          radix_sort_nc
+  #define american_flag_sort  american_flag_sort_nc
+  #define counting_sort_range counting_sort_range_nc
+  #define counting_sort       counting_sort_nc
+  #define placement_sort      placement_sort_nc
+  #define narrow_sort         narrow_sort_nc
+  #define sort_statistics     sort_statistics_nc
+  #define adaptive_sort       adaptive_sort_nc
+  #define SelectSort64          SelectSort64_nc
+  #define SelectSortInv64       SelectSortInv64_nc
+  #define min64                 min64_nc
+  #define mergesort64           mergesort64_nc
+  #define merge64               merge64_nc
+  #define quicksort64           quicksort64_nc
+  #define partition64           partition64_nc
+  #define median64              median64_nc
+  #define median_avg64          median_avg64_nc
+  #define median_stat64         median_stat64_nc
+  #define InsertSort64          InsertSort64_nc
+  #define HeapSort64            HeapSort64_nc
+  #define introsort64           introsort64_nc
+  #define partial_sort64        partial_sort64_nc
+  #define topk_init             topk_init_nc
+  #define topk_free             topk_free_nc
+  #define topk_push             topk_push_nc
+  #define topk_result           topk_result_nc
+  #define pdqsort64             pdqsort64_nc
+  #define natural_mergesort64   natural_mergesort64_nc
+  #define radix_sort64          radix_sort64_nc
+  #define american_flag_sort64  american_flag_sort64_nc
+  #define radix_sort_double     radix_sort_double_nc
+  #define radix_sort_float      radix_sort_float_nc
+  #define counting_sort_range64 counting_sort_range64_nc
+  #define counting_sort64       counting_sort64_nc
+  #define placement_sort64      placement_sort64_nc
+  #define narrow_sort64         narrow_sort64_nc
+  #define sort_statistics64     sort_statistics64_nc
+  #define adaptive_sort64       adaptive_sort64_nc
+#endif
 
 /* Functions */
 int SelectSort(int* array, int ip, int iu);
@@ -28,11 +164,130 @@ int SelectSortInv(int* array, int ip, int iu);
 int min(int* array, int ip, int iu, int *ob);
 int mergesort(int *tabla, int ip, int iu);
 int merge(int *tabla, int ip, int iu, int imedio);
+int set_merge_path(int path);
+int set_stream_threshold(long bytes);
+int set_sort_base_case(int size);
 int quicksort(int *tabla, int ip, int iu);
 int partition(int *tabla, int ip, int iu, int *pos);
 int median(int *tabla, int ip, int iu, int *pos);
 int median_avg(int *tabla, int ip, int iu, int *pos);
 int median_stat(int *tabla, int ip, int iu, int *pos);
+int InsertSort(int *tabla, int ip, int iu);
+int HeapSort(int *tabla, int ip, int iu);
+int introsort(int *tabla, int ip, int iu);
+int partial_sort(int *tabla, int ip, int iu, int k);
+int pdqsort(int *tabla, int ip, int iu);
+int natural_mergesort(int *tabla, int ip, int iu);
+int radix_sort(int *tabla, int ip, int iu);
+int american_flag_sort(int *tabla, int ip, int iu);
+int counting_sort_range(int *tabla, int ip, int iu, int minimum, int maximum);
+int counting_sort(int *tabla, int ip, int iu);
+int placement_sort(int *tabla, int ip, int iu);
+int narrow_sort(int *tabla, int ip, int iu);
+
+/* 64-bit versions: the functions above are thin wrappers over them */
+long SelectSort64(int* array, long ip, long iu);
+long SelectSortInv64(int* array, long ip, long iu);
+long min64(int* array, long ip, long iu, long *ob);
+long mergesort64(int *tabla, long ip, long iu);
+long merge64(int *tabla, long ip, long iu, long imedio);
+long quicksort64(int *tabla, long ip, long iu);
+long partition64(int *tabla, long ip, long iu, long *pos);
+long median64(int *tabla, long ip, long iu, long *pos);
+long median_avg64(int *tabla, long ip, long iu, long *pos);
+long median_stat64(int *tabla, long ip, long iu, long *pos);
+long InsertSort64(int *tabla, long ip, long iu);
+long HeapSort64(int *tabla, long ip, long iu);
+long introsort64(int *tabla, long ip, long iu);
+long partial_sort64(int *tabla, long ip, long iu, long k);
+long pdqsort64(int *tabla, long ip, long iu);
+long natural_mergesort64(int *tabla, long ip, long iu);
+long radix_sort64(int *tabla, long ip, long iu);
+long american_flag_sort64(int *tabla, long ip, long iu);
+long counting_sort_range64(int *tabla, long ip, long iu, int minimum, int maximum);
+long counting_sort64(int *tabla, long ip, long iu);
+long placement_sort64(int *tabla, long ip, long iu);
+long narrow_sort64(int *tabla, long ip, long iu);
+long sort_statistics64(int *tabla, long ip, long iu, PSORT_STATS pstats);
+long adaptive_sort64(int *tabla, long ip, long iu);
+pfunc_sort64 wide_sort(pfunc_sort method);
+
+/* Radix sort of floating point values. NaNs are left at the end and 
+ * -0.0 before +0.0 */
+long radix_sort_double(double *tabla, long ip, long iu);
+long radix_sort_float(float *tabla, long ip, long iu);
+
+/* Streaming top-k accumulator */
+PTOPK topk_init(long k);
+void topk_free(PTOPK ptopk);
+long topk_push(PTOPK ptopk, const int *chunk, long n);
+long topk_result(PTOPK ptopk, int *out, long *n_out);
+
+/* Adaptive dispatcher */
+int sort_statistics(int *tabla, int ip, int iu, PSORT_STATS pstats);
+int adaptive_choose_engine(PSORT_STATS pstats);
+int adaptive_sort(int *tabla, int ip, int iu);
+void adaptive_sort_log(FILE *pf);
+const char *adaptive_engine_name(int engine);
+
+/* Uncounted variants, built from the same source */
+int SelectSort_nc(int* array, int ip, int iu);
+int SelectSortInv_nc(int* array, int ip, int iu);
+int min_nc(int* array, int ip, int iu, int *ob);
+int mergesort_nc(int *tabla, int ip, int iu);
+int merge_nc(int *tabla, int ip, int iu, int imedio);
+int quicksort_nc(int *tabla, int ip, int iu);
+int partition_nc(int *tabla, int ip, int iu, int *pos);
+int median_nc(int *tabla, int ip, int iu, int *pos);
+int median_avg_nc(int *tabla, int ip, int iu, int *pos);
+int median_stat_nc(int *tabla, int ip, int iu, int *pos);
+int InsertSort_nc(int *tabla, int ip, int iu);
+int HeapSort_nc(int *tabla, int ip, int iu);
+int introsort_nc(int *tabla, int ip, int iu);
+int partial_sort_nc(int *tabla, int ip, int iu, int k);
+int pdqsort_nc(int *tabla, int ip, int iu);
+int natural_mergesort_nc(int *tabla, int ip, int iu);
+int radix_sort_nc(int *tabla, int ip, int iu);
+int american_flag_sort_nc(int *tabla, int ip, int iu);
+int counting_sort_range_nc(int *tabla, int ip, int iu, int minimum, int maximum);
+int counting_sort_nc(int *tabla, int ip, int iu);
+int placement_sort_nc(int *tabla, int ip, int iu);
+int narrow_sort_nc(int *tabla, int ip, int iu);
+int sort_statistics_nc(int *tabla, int ip, int iu, PSORT_STATS pstats);
+int adaptive_sort_nc(int *tabla, int ip, int iu);
+pfunc_sort uncounted_sort(pfunc_sort method);
+long SelectSort64_nc(int* array, long ip, long iu);
+long SelectSortInv64_nc(int* array, long ip, long iu);
+long min64_nc(int* array, long ip, long iu, long *ob);
+long mergesort64_nc(int *tabla, long ip, long iu);
+long merge64_nc(int *tabla, long ip, long iu, long imedio);
+long quicksort64_nc(int *tabla, long ip, long iu);
+long partition64_nc(int *tabla, long ip, long iu, long *pos);
+long median64_nc(int *tabla, long ip, long iu, long *pos);
+long median_avg64_nc(int *tabla, long ip, long iu, long *pos);
+long median_stat64_nc(int *tabla, long ip, long iu, long *pos);
+long InsertSort64_nc(int *tabla, long ip, long iu);
+long HeapSort64_nc(int *tabla, long ip, long iu);
+long introsort64_nc(int *tabla, long ip, long iu);
+long partial_sort64_nc(int *tabla, long ip, long iu, long k);
+PTOPK topk_init_nc(long k);
+void topk_free_nc(PTOPK ptopk);
+long topk_push_nc(PTOPK ptopk, const int *chunk, long n);
+long topk_result_nc(PTOPK ptopk, int *out, long *n_out);
+long pdqsort64_nc(int *tabla, long ip, long iu);
+long natural_mergesort64_nc(int *tabla, long ip, long iu);
+long radix_sort64_nc(int *tabla, long ip, long iu);
+long american_flag_sort64_nc(int *tabla, long ip, long iu);
+long counting_sort_range64_nc(int *tabla, long ip, long iu, int minimum, int maximum);
+long counting_sort64_nc(int *tabla, long ip, long iu);
+long placement_sort64_nc(int *tabla, long ip, long iu);
+long narrow_sort64_nc(int *tabla, long ip, long iu);
+long sort_statistics64_nc(int *tabla, long ip, long iu, PSORT_STATS pstats);
+long adaptive_sort64_nc(int *tabla, long ip, long iu);
+pfunc_sort64 uncounted_sort64(pfunc_sort64 method);
+long radix_sort_double_nc(double *tabla, long ip, long iu);
+long radix_sort_float_nc(float *tabla, long ip, long iu);
+pfunc_sort_double uncounted_sort_double(pfunc_sort_double method);
 
 
 #endif
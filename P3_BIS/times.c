@@ -9,6 +9,8 @@
  *
  */
 
+#define _POSIX_C_SOURCE 199309L
+
 #include <stdlib.h>
 #include <stdio.h>
 #include <time.h>
@@ -16,70 +18,161 @@
 #include <assert.h>
 #include "times.h"
 #include "sorting.h"
+#include "batch.h"
 #include "permutations.h"
 
-/*******************************************************/
-/* Function: average_sorting_time Date:                */
-/*                                                     */
-/* Function that sorts a number of permutations        */
-/* with a method and stores time spent and number      */
-/* of ob in a structure                                */
-/*                                                     */
-/* Input:                                              */
-/* pfunc_sort metodo: pointer to the method that sorts */
-/* the permutation                                     */
-/* int n_perms: Number of permutations to sort         */
-/* int N: Number of elements of each permutation       */
-/* PTIME_AA ptime: pointer to the struct time_aa       */
-/* Output:                                             */
-/* OK                                                  */
-/* ERR in case of error                                */
-/*******************************************************/
-short average_sorting_time(pfunc_sort metodo, int n_perms, int N, PTIME_AA ptime)
+/**
+ * Stores in ptime the average of each kind of operation
+ * @param ptime pointer to the struct time_aa
+ * @param pcounters pointer to the counters accumulated over n runs
+ * @param n number of runs
+ */
+static void average_counters(PTIME_AA ptime, PCOUNTERS pcounters, long n)
+{
+  ptime->average_cmp = pcounters->comparisons / (double)n;
+  ptime->average_swaps = pcounters->swaps / (double)n;
+  ptime->average_moves = pcounters->moves / (double)n;
+  ptime->average_allocs = pcounters->allocations / (double)n;
+  ptime->average_bytes = pcounters->bytes / (double)n;
+}
+
+/* Shape of the permutations sorted by average_sorting_time */
+static int input_shape = SHAPE_RANDOM;
+
+/* Function that fills a TIME_AA with the average times of N elements */
+typedef short (*pfunc_average)(pfunc_sort, long, long, PTIME_AA);
+
+/* Function that fills a TIME_AA searching some keys in a dictionary */
+typedef short (*pfunc_time_keys)(PDICT, int *, long, pfunc_search64, pfunc_search_batch,
+                                 PTIME_AA);
+
+/**
+ * Returns the wall clock time in nanoseconds. Unlike clock(), it does not
+ * add up the CPU time of all the threads, so it is used to time the
+ * functions that run on the thread pool
+ * @return Nanoseconds since an arbitrary point
+ *         ERR in case of error
+ */
+static double wall_time(void)
 {
-  int i;
-  int ob, min_ob = INT_MAX, max_ob = 0;
+  struct timespec ts;
+
+  if (clock_gettime(CLOCK_MONOTONIC, &ts) != 0)
+    return ERR;
+
+  return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+/**
+ * Sorts an array of N elements with the 64-bit version of a sorting
+ * function or, if it has none, with the function of the int interface,
+ * whose ob saturate at INT_MAX as those of narrow_ob
+ * @param metodo sorting function of the int interface, used if metodo64 is NULL
+ * @param metodo64 64-bit sorting function, can be NULL
+ * @param tabla array to sort
+ * @param N number of elements of tabla
+ * @return Number of basic operations performed
+ *         ERR in case of error
+ */
+static long sort_once(pfunc_sort metodo, pfunc_sort64 metodo64, int *tabla, long N)
+{
+  if (metodo64 != NULL)
+    return metodo64(tabla, 0, N - 1);
+
+  if (N - 1 > INT_MAX)
+    return ERR;
+
+  return metodo(tabla, 0, (int)(N - 1));
+}
+
+/**
+ * Common part of average_sorting_time and average_sorting_time64
+ * @param metodo sorting function of the int interface, used if metodo64 is NULL
+ * @param metodo64 64-bit sorting function, can be NULL
+ * @param n_perms number of permutations to sort
+ * @param N number of elements of each permutation
+ * @param ptime pointer to the struct time_aa
+ * @return OK
+ *         ERR in case of error
+ */
+static short average_sort(pfunc_sort metodo, pfunc_sort64 metodo64, long n_perms, long N,
+                          PTIME_AA ptime)
+{
+  long i, j;
+  long ob, min_ob = LONG_MAX, max_ob = 0;
   long suma_obs = 0;
-  int **perms = NULL;
+  int **perms = NULL, *copia = NULL;
+  pfunc_sort rapido = NULL;
+  pfunc_sort64 rapido64 = NULL;
+  COUNTERS cuentas;
+  PCOUNTERS previas;
   double tiempo;
   long double suma_tiempo = 0;
   clock_t begin, end;
 
   /* Control de errores */
-  if (metodo == NULL || n_perms < 1 || N < 1 || ptime == NULL)
+  if ((metodo == NULL && metodo64 == NULL) || n_perms < 1 || N < 1 || ptime == NULL)
     return ERR;
 
+  /* Se cronometra la variante sin contar y las ob salen de la que cuenta */
+  if (metodo64 != NULL)
+    rapido64 = uncounted_sort64(metodo64);
+  else
+    rapido = uncounted_sort(metodo);
+
   /* Rellenamos los dos primeros campos de la estructura time */
   ptime->N = N;
   ptime->n_elems = n_perms;
 
   /* Generamos las permutaciones */
-  perms = generate_permutations(n_perms, N);
+  perms = generate_permutations64(n_perms, N);
 
   if (perms == NULL)
     return ERR;
 
+  for (i = 0; i < n_perms; i++)
+    shape_perm64(perms[i], N, input_shape);
+
+  /* Copia de cada permutación para la variante que cuenta */
+  copia = (int *)malloc((size_t)N * sizeof(copia[0]));
+  if (copia == NULL)
+  {
+    free_permutations64(perms, n_perms);
+    return ERR;
+  }
+
+  /* Contamos cada tipo de operación de la variante que cuenta */
+  reset_counters(&cuentas);
+
   /* Ordenamos cada permutación con un bucle desde la pos 0 a n_perms */
   for (i = 0; i < n_perms; i++)
   {
-    begin = clock();
-    if (begin == (clock_t)-1)
+    for (j = 0; j < N; j++)
+      copia[j] = perms[i][j];
+
+    previas = set_counters(&cuentas);
+    ob = sort_once(metodo, metodo64, copia, N);
+    set_counters(previas);
+    if (ob == ERR)
     {
-      free_permutations(perms, n_perms);
+      free(copia);
+      free_permutations64(perms, n_perms);
       return ERR;
     }
 
-    ob = metodo(perms[i], 0, N - 1);
-    if (ob == ERR)
+    begin = clock();
+    if (begin == (clock_t)-1 || sort_once(rapido, rapido64, perms[i], N) == ERR)
     {
-      free_permutations(perms, n_perms);
+      free(copia);
+      free_permutations64(perms, n_perms);
       return ERR;
     }
 
     end = clock();
     if (end == (clock_t)-1)
     {
-      free_permutations(perms, n_perms);
+      free(copia);
+      free_permutations64(perms, n_perms);
       return ERR;
     }
 
@@ -103,8 +196,124 @@ short average_sorting_time(pfunc_sort metodo, int n_perms, int N, PTIME_AA ptime
   ptime->average_ob = suma_obs / (double)n_perms;
   ptime->min_ob = min_ob;
   ptime->max_ob = max_ob;
+  average_counters(ptime, &cuentas, n_perms);
 
-  free_permutations(perms, n_perms);
+  free(copia);
+  free_permutations64(perms, n_perms);
+  return OK;
+}
+
+/*******************************************************/
+/* Function: average_sorting_time Date:                */
+/*                                                     */
+/* Function that sorts a number of permutations        */
+/* with a method and stores time spent and number      */
+/* of ob in a structure                                */
+/*                                                     */
+/* Input:                                              */
+/* pfunc_sort metodo: pointer to the method that sorts */
+/* the permutation                                     */
+/* long n_perms: Number of permutations to sort        */
+/* long N: Number of elements of each permutation      */
+/* PTIME_AA ptime: pointer to the struct time_aa       */
+/* Output:                                             */
+/* OK                                                  */
+/* ERR in case of error                                */
+/*******************************************************/
+short average_sorting_time(pfunc_sort metodo, long n_perms, long N, PTIME_AA ptime)
+{
+  if (metodo == NULL)
+    return ERR;
+
+  return average_sort(metodo, wide_sort(metodo), n_perms, N, ptime);
+}
+
+/**
+ * 64-bit version of average_sorting_time: sizes and ob are long
+ * @param metodo 64-bit sorting function
+ * @param n_perms number of permutations to sort
+ * @param N number of elements of each permutation
+ * @param ptime pointer to the struct time_aa
+ * @return OK
+ *         ERR in case of error
+ */
+short average_sorting_time64(pfunc_sort64 metodo, long n_perms, long N, PTIME_AA ptime)
+{
+  if (metodo == NULL)
+    return ERR;
+
+  return average_sort(NULL, metodo, n_perms, N, ptime);
+}
+
+/**
+ * Sets the shape of the permutations sorted by average_sorting_time and
+ * generate_sorting_times, so the algorithms can be compared on patterned
+ * inputs
+ * @param shape one of the SHAPE_* constants of permutations.h
+ * @return OK
+ *         ERR if the shape does not exist
+ */
+short set_input_shape(int shape)
+{
+  if (shape < SHAPE_RANDOM || shape > SHAPE_FEW_UNIQUE)
+    return ERR;
+
+  input_shape = shape;
+  return OK;
+}
+
+/**
+ * Calls average for every size from num_min to num_max with step incr 
+ * and saves the resulting table in file
+ * @param average function that measures the times of one size
+ * @param method sorting function
+ * @param file name of the output file
+ * @param num_min minimum size of the permutations
+ * @param num_max maximum size of the permutations
+ * @param incr increment of the size of the permutations
+ * @param n_perms number of permutations to sort for each size
+ * @return OK
+ *         ERR in case of error
+ */
+static short generate_times(pfunc_average average, pfunc_sort method, char *file,
+                            long num_min, long num_max, long incr, long n_perms)
+{
+  TIME_AA *time = NULL;
+  long i, j, n_times;
+  short status = ERR;
+
+  /* Control de errores inicial */
+  if (method == NULL || file == NULL || num_min < 1 || num_min > num_max || incr < 1 || n_perms < 1)
+    return ERR;
+
+  n_times = ((num_max - num_min) / incr) + 1;
+  /* Guardamos memoria para los tiempos de ejecución */
+  time = (TIME_AA *)malloc((size_t)n_times * sizeof(time[0]));
+
+  if (time == NULL)
+    return ERR;
+
+  /* Generamos en este array todos los tiempos medios y los imprimimos */
+  for (i = 0, j = num_min; i < n_times && j <= num_max; i++, j += incr)
+  {
+    status = average(method, n_perms, j, &time[i]);
+
+    if (status == ERR)
+    {
+      free(time);
+      return ERR;
+    }
+  }
+
+  status = save_time_table(file, time, n_times);
+
+  if (status == ERR)
+  {
+    free(time);
+    return ERR;
+  }
+
+  free(time);
   return OK;
 }
 
@@ -120,48 +329,154 @@ short average_sorting_time(pfunc_sort metodo, int n_perms, int N, PTIME_AA ptime
 /* pfunc_sort metodo: pointer to the method that sorts  */
 /* the permutation                                      */
 /* char *file: pointer to the name of the file          */
-/* int num_min: minimum size of the permutations        */
-/* int num_max: maximum size of the permutations        */
-/* int incr: increment to the size of the permutation   */
-/* int n_perms: Number of permutations to sort          */
+/* long num_min: minimum size of the permutations       */
+/* long num_max: maximum size of the permutations       */
+/* long incr: increment to the size of the permutation  */
+/* long n_perms: Number of permutations to sort         */
 /* Output:                                              */
 /* OK                                                   */
 /* ERR in case of error                                 */
 /********************************************************/
-short generate_sorting_times(pfunc_sort method, char *file, int num_min, int num_max,
-                             int incr, int n_perms)
+short generate_sorting_times(pfunc_sort method, char *file, long num_min, long num_max,
+                             long incr, long n_perms)
+{
+  return generate_times(average_sorting_time, method, file, num_min, num_max, incr, n_perms);
+}
+
+/**
+ * Same as average_sorting_time for a sorting function of doubles. Each 
+ * permutation of 1..N is turned into the doubles (perm[i] - N/2) / 3, 
+ * which have sign and fractional part
+ * @param metodo sorting function of doubles
+ * @param n_perms number of arrays to sort
+ * @param N number of elements of each array
+ * @param ptime pointer to the struct time_aa
+ * @return OK
+ *         ERR in case of error
+ */
+short average_sorting_time_double(pfunc_sort_double metodo, long n_perms, long N, PTIME_AA ptime)
+{
+  long i, j;
+  long ob, min_ob = LONG_MAX, max_ob = 0;
+  long suma_obs = 0;
+  int **perms = NULL;
+  double *datos = NULL, *copia = NULL;
+  pfunc_sort_double rapido;
+  COUNTERS cuentas;
+  PCOUNTERS previas;
+  long double suma_tiempo = 0;
+  clock_t begin, end;
+
+  /* Control de errores */
+  if (metodo == NULL || n_perms < 1 || N < 1 || ptime == NULL)
+    return ERR;
+
+  rapido = uncounted_sort_double(metodo);
+
+  perms = generate_permutations64(n_perms, N);
+  if (perms == NULL)
+    return ERR;
+
+  datos = (double *)malloc((size_t)N * sizeof(datos[0]));
+  copia = (double *)malloc((size_t)N * sizeof(copia[0]));
+  if (datos == NULL || copia == NULL)
+  {
+    free(datos);
+    free(copia);
+    free_permutations64(perms, n_perms);
+    return ERR;
+  }
+
+  reset_counters(&cuentas);
+
+  for (i = 0; i < n_perms; i++)
+  {
+    for (j = 0; j < N; j++)
+      datos[j] = copia[j] = (perms[i][j] - N / 2.0) / 3.0;
+
+    /* ob de la variante que cuenta, tiempo de la que no */
+    previas = set_counters(&cuentas);
+    ob = metodo(copia, 0, N - 1);
+    set_counters(previas);
+
+    begin = clock();
+    if (ob == ERR || begin == (clock_t)-1 || rapido(datos, 0, N - 1) == ERR)
+    {
+      free(datos);
+      free(copia);
+      free_permutations64(perms, n_perms);
+      return ERR;
+    }
+
+    end = clock();
+    if (end == (clock_t)-1)
+    {
+      free(datos);
+      free(copia);
+      free_permutations64(perms, n_perms);
+      return ERR;
+    }
+
+    suma_obs += ob;
+    if (min_ob > ob)
+      min_ob = ob;
+    if (max_ob < ob)
+      max_ob = ob;
+
+    suma_tiempo += (double)(end - begin) / CLOCKS_PER_SEC * 1e9; /* en nanosegundos */
+  }
+
+  ptime->N = N;
+  ptime->n_elems = n_perms;
+  ptime->time = suma_tiempo / (double)n_perms;
+  ptime->average_ob = suma_obs / (double)n_perms;
+  ptime->min_ob = min_ob;
+  ptime->max_ob = max_ob;
+  average_counters(ptime, &cuentas, n_perms);
+
+  free(datos);
+  free(copia);
+  free_permutations64(perms, n_perms);
+  return OK;
+}
+
+/**
+ * Same as generate_sorting_times for a sorting function of doubles,
+ * measuring each size with average_sorting_time_double
+ * @param method sorting function of doubles
+ * @param file name of the output file
+ * @param num_min minimum size of the arrays
+ * @param num_max maximum size of the arrays
+ * @param incr increment of the size of the arrays
+ * @param n_perms number of arrays to sort for each size
+ * @return OK
+ *         ERR in case of error
+ */
+short generate_sorting_times_double(pfunc_sort_double method, char *file, long num_min, long num_max,
+                                    long incr, long n_perms)
 {
   TIME_AA *time = NULL;
-  int i, j, n_times;
-  short status = ERR;
+  long i, j, n_times;
 
   /* Control de errores inicial */
-  if (method == NULL || file == NULL || num_min < 1 || num_min > num_max || n_perms < 1)
+  if (method == NULL || file == NULL || num_min < 1 || num_min > num_max || incr < 1 || n_perms < 1)
     return ERR;
 
-  /* TODO: Comentar esto en la memoria */
   n_times = ((num_max - num_min) / incr) + 1;
-  /* Guardamos memoria para los tiempos de ejecución */
-  time = (TIME_AA *)malloc(n_times * sizeof(time[0]));
-
+  time = (TIME_AA *)malloc((size_t)n_times * sizeof(time[0]));
   if (time == NULL)
     return ERR;
 
-  /* Generamos en este array todos los tiempos medios y los imprimimos */
-  for (i = 0, j = num_min; i < n_perms && j <= num_max; i++, j += incr)
+  for (i = 0, j = num_min; i < n_times && j <= num_max; i++, j += incr)
   {
-    status = average_sorting_time(method, n_perms, j, &time[i]);
-
-    if (status == ERR)
+    if (average_sorting_time_double(method, n_perms, j, &time[i]) == ERR)
     {
       free(time);
       return ERR;
     }
   }
 
-  status = save_time_table(file, time, n_times);
-
-  if (status == ERR)
+  if (save_time_table(file, time, n_times) == ERR)
   {
     free(time);
     return ERR;
@@ -171,25 +486,132 @@ short generate_sorting_times(pfunc_sort method, char *file, int num_min, int num
   return OK;
 }
 
+/**
+ * Same as average_sorting_time, but the n_perms permutations are sorted
+ * with one call to sort_batch. The time of each permutation is the wall
+ * clock time of the uncounted batch divided by n_perms. sort_batch works
+ * on int sizes, so n_perms and N can be at most INT_MAX
+ * @param metodo sorting function for the arrays bigger than BATCH_SIMD_MAX
+ * @param n_perms number of permutations to sort
+ * @param N number of elements of each permutation
+ * @param ptime pointer to the struct time_aa
+ * @return OK
+ *         ERR in case of error
+ */
+short average_batch_sorting_time(pfunc_sort metodo, long n_perms, long N, PTIME_AA ptime)
+{
+  int i, j, *obs = NULL, min_ob = INT_MAX, max_ob = 0;
+  int **perms = NULL, **copias = NULL;
+  long suma_obs, st;
+  COUNTERS cuentas;
+  PCOUNTERS previas;
+  double begin, end;
+
+  /* Control de errores */
+  if (metodo == NULL || n_perms < 1 || N < 1 || n_perms > INT_MAX || N > INT_MAX || ptime == NULL)
+    return ERR;
+
+  perms = generate_permutations(n_perms, N);
+  if (perms == NULL)
+    return ERR;
+
+  /* Copias de las permutaciones para la variante que cuenta */
+  copias = generate_permutations(n_perms, N);
+  obs = (int *)malloc(n_perms * sizeof(obs[0]));
+  if (copias == NULL || obs == NULL)
+  {
+    free(obs);
+    if (copias != NULL)
+      free_permutations(copias, n_perms);
+    free_permutations(perms, n_perms);
+    return ERR;
+  }
+
+  for (i = 0; i < n_perms; i++)
+  {
+    for (j = 0; j < N; j++)
+      copias[i][j] = perms[i][j];
+  }
+
+  reset_counters(&cuentas);
+  previas = set_counters(&cuentas);
+  suma_obs = sort_batch(copias, n_perms, N, metodo, obs);
+  set_counters(previas);
+
+  begin = wall_time();
+  st = sort_batch(perms, n_perms, N, uncounted_sort(metodo), NULL);
+  end = wall_time();
+
+  if (begin == ERR || end == ERR || suma_obs == ERR || st == ERR)
+  {
+    free(obs);
+    free_permutations(copias, n_perms);
+    free_permutations(perms, n_perms);
+    return ERR;
+  }
+
+  /* Almacenamos valor mínimo y máximo */
+  for (i = 0; i < n_perms; i++)
+  {
+    if (min_ob > obs[i])
+      min_ob = obs[i];
+    if (max_ob < obs[i])
+      max_ob = obs[i];
+  }
+
+  ptime->N = N;
+  ptime->n_elems = n_perms;
+  ptime->time = (end - begin) / n_perms;
+  ptime->average_ob = suma_obs / (double)n_perms;
+  ptime->min_ob = min_ob;
+  ptime->max_ob = max_ob;
+  average_counters(ptime, &cuentas, n_perms);
+
+  free(obs);
+  free_permutations(copias, n_perms);
+  free_permutations(perms, n_perms);
+  return OK;
+}
+
+/**
+ * Same as generate_sorting_times, sorting the permutations of each size
+ * with average_batch_sorting_time
+ * @param method sorting function for the arrays bigger than BATCH_SIMD_MAX
+ * @param file name of the output file
+ * @param num_min minimum size of the permutations
+ * @param num_max maximum size of the permutations
+ * @param incr increment of the size of the permutations
+ * @param n_perms number of permutations to sort for each size
+ * @return OK
+ *         ERR in case of error
+ */
+short generate_batch_sorting_times(pfunc_sort method, char *file, long num_min, long num_max,
+                                   long incr, long n_perms)
+{
+  return generate_times(average_batch_sorting_time, method, file, num_min, num_max, incr, n_perms);
+}
+
 /********************************************************/
 /* Function: save_time_table Date:                      */
 /*                                                      */
 /* Function that prints the elements of the struct for  */
-/* each size of permutation in a file                   */
+/* each size of permutation in a file: N, time, average */
+/* min and max ob, and the average comparisons, swaps,  */
+/* moves, allocations and bytes copied                  */
 /*                                                      */
 /* Input:                                               */
 /* char *file: pointer to the name of the file          */
 /* PTIME_AA ptime: pointer to the struct time_aa        */
-/* int n_times: number of times that the increment is   */
+/* long n_times: number of times that the increment is  */
 /* realised                                             */
 /* Output:                                              */
 /* OK                                                   */
 /* ERR in case of error                                 */
 /********************************************************/
-short save_time_table(char *file, PTIME_AA ptime, int n_times)
+short save_time_table(char *file, PTIME_AA ptime, long n_times)
 {
   FILE *pf;
-  int i;
+  long i;
 
   if (ptime == NULL)
     return ERR;
@@ -201,7 +623,10 @@ short save_time_table(char *file, PTIME_AA ptime, int n_times)
 
   for (i = 0; i < n_times; i++)
   {
-    if (fprintf(pf, "%d %.2f %.2f %d %d\n", ptime[i].N, ptime[i].time, ptime[i].average_ob, ptime[i].min_ob, ptime[i].max_ob) < 0)
+    if (fprintf(pf, "%ld %.2f %.2f %ld %ld %.2f %.2f %.2f %.2f %.2f\n", ptime[i].N, ptime[i].time,
+                ptime[i].average_ob, ptime[i].min_ob, ptime[i].max_ob,
+                ptime[i].average_cmp, ptime[i].average_swaps, ptime[i].average_moves,
+                ptime[i].average_allocs, ptime[i].average_bytes) < 0)
     {
       fclose(pf);
       return ERR;
@@ -213,157 +638,561 @@ short save_time_table(char *file, PTIME_AA ptime, int n_times)
   return OK;
 }
 
-short generate_search_times(pfunc_search method, pfunc_key_generator generator,
-                            int order, char *file,
-                            int num_min, int num_max,
-                            int incr, int n_times)
+/**
+ * Searches the n_keys keys of tsearch in the dictionary twice: once with 
+ * metodo to take the ob and once with its uncounted variant to take the
+ * time. The table is restored between both passes, since lin_auto_search
+ * modifies it
+ * @param pdict pointer to the dictionary
+ * @param tsearch keys to search
+ * @param n_keys number of keys
+ * @param metodo search function
+ * @param lote unused
+ * @param ptime pointer to the struct time_aa where time and ob are stored
+ * @return OK
+ *         ERR in case of error
+ */
+static short time_search_keys(PDICT pdict, int *tsearch, long n_keys,
+                              pfunc_search64 metodo, pfunc_search_batch lote,
+                              PTIME_AA ptime)
 {
-  TIME_AA *time = NULL;
-  int i, j, N;
-  short status = ERR;
+  int *copia = NULL;
+  long i, min_ob = LONG_MAX, max_ob = 0, ob, pos = 0;
+  pfunc_search64 rapido;
+  long suma_obs = 0;
+  COUNTERS cuentas;
+  PCOUNTERS previas;
+  clock_t begin, end;
 
-  /* Control de errores inicial */
-  assert(method != NULL);
-  assert(generator != NULL);
-  assert(file != NULL);
-  assert(num_min <= num_max);
+  (void)lote;
+  rapido = uncounted_search64(metodo);
 
-  /* Guardamos memoria para los tiempos de ejecución */
-  time = (PTIME_AA)malloc(n_times * sizeof(time[0]));
-  if (time == NULL)
+  /* Guardamos la tabla para la segunda pasada */
+  copia = (int *)malloc((size_t)pdict->n_data * sizeof(copia[0]));
+  if (copia == NULL)
     return ERR;
 
-  N = num_max - num_min;
+  for (i = 0; i < pdict->n_data; i++)
+    copia[i] = pdict->table[i];
 
-  /* Generamos en este array todos los tiempos medios y los imprimimos */
-  for (i = 0, j = num_min; i < N * n_times && j <= num_max; i++, j += incr)
+  /* Primera pasada: ob de la variante que cuenta */
+  reset_counters(&cuentas);
+  for (i = 0; i < n_keys; i++)
   {
-    status = average_search_time(method, generator, order, N, n_times, &time[i]);
-    if (status == ERR)
+    previas = set_counters(&cuentas);
+    ob = search_dictionary64(pdict, tsearch[i], &pos, metodo);
+    set_counters(previas);
+    if (ob == ERR)
     {
-      free(time);
+      free(copia);
       return ERR;
     }
+
+    /* Almacenamos las obs */
+    suma_obs += ob;
+
+    /* Almacenamos valor mínimo y máximo */
+    if (min_ob > ob)
+      min_ob = ob;
+
+    if (max_ob < ob)
+      max_ob = ob;
   }
 
-  status = save_time_table(file, time, n_times);
+  for (i = 0; i < pdict->n_data; i++)
+    pdict->table[i] = copia[i];
 
-  if (status == ERR)
-  {
-    free(time);
+  free(copia);
+
+  /* Segunda pasada: tiempo de la variante sin contar */
+  begin = clock();
+  if (begin == (clock_t)-1)
     return ERR;
+
+  for (i = 0; i < n_keys; i++)
+  {
+    if (search_dictionary64(pdict, tsearch[i], &pos, rapido) == ERR)
+      return ERR;
   }
 
-  free(time);
+  end = clock();
+  if (end == (clock_t)-1)
+    return ERR;
+
+  ptime->time = (double)(end - begin) / CLOCKS_PER_SEC * 1e9 / n_keys; /* en nanosegundos */
+  ptime->average_ob = suma_obs / (double)n_keys;
+  ptime->min_ob = min_ob;
+  ptime->max_ob = max_ob;
+  average_counters(ptime, &cuentas, n_keys);
+
   return OK;
 }
 
-short average_search_time(pfunc_search metodo, pfunc_key_generator generator,
-                          int order,
-                          int N,
-                          int n_times,
-                          PTIME_AA ptime)
+/**
+ * Creates a dictionary of size N with the keys of a permutation of size N
+ * @param order order of the dictionary
+ * @param N size of the dictionary
+ * @return Pointer to the dictionary
+ *         NULL in case of error
+ */
+static PDICT search_dictionary_of(int order, long N)
 {
   PDICT pdict = NULL;
-  int *perm = NULL, st, n_keys, *tsearch = NULL, i, min_ob = INT_MAX, max_ob = 0, ob, pos = 0;
-  long suma_obs = 0;
-  double tiempo;
-  long double suma_tiempo = 0;
-  clock_t begin, end;
-
-  /* Control de errores */
-  assert(metodo != NULL);
-  assert(generator != NULL);
-  assert(ptime != NULL);
-  assert(n_times > 0 && N > 0);
+  int *perm = NULL;
+  long st;
 
   /* Creamos un diccionario de tamaño N */
-  pdict = init_dictionary(N, order);
+  pdict = init_dictionary64(N, order);
   if (pdict == NULL)
-    return ERR;
+    return NULL;
+
+  /* Cada método se cronometra tal cual, sin pasar por el S-tree */
+  if (order == SORTED && set_dictionary_index(pdict, INDEX_NONE) == ERR)
+  {
+    free_dictionary(pdict);
+    return NULL;
+  }
 
   /* Creamos una permutación de tamaño N */
-  perm = generate_perm(N);
+  perm = generate_perm64(N);
   if (perm == NULL)
   {
     free_dictionary(pdict);
-    return ERR;
+    return NULL;
   }
 
   /* Insertamos los elementos de la permutación */
-  st = massive_insertion_dictionary(pdict, perm, N);
+  st = massive_insertion_dictionary64(pdict, perm, N);
+  free(perm);
   if (st == ERR)
   {
     free_dictionary(pdict);
-    free(perm);
-    return ERR;
+    return NULL;
   }
 
+  return pdict;
+}
+
+/**
+ * Fills keys with the 64-bit generator, or with the int one if generator64
+ * is NULL and n_keys fits in an int
+ * @param generator int generator of the keys
+ * @param generator64 64-bit generator of the keys
+ * @param keys table where the keys are stored
+ * @param n_keys number of keys
+ * @param max maximum key
+ * @return OK
+ *         ERR if n_keys does not fit in the int generator
+ */
+static short generate_keys(pfunc_key_generator generator,
+                           pfunc_key_generator64 generator64,
+                           int *keys, long n_keys, int max)
+{
+  if (generator64 != NULL)
+  {
+    generator64(keys, n_keys, max);
+    return OK;
+  }
+
+  if (n_keys > INT_MAX)
+    return ERR;
+
+  generator(keys, (int)n_keys, max);
+
+  return OK;
+}
+
+/**
+ * Builds a dictionary with a permutation of size N, generates n_times * N
+ * keys and searches them with timer
+ * @param timer function that searches the keys and fills ptime
+ * @param metodo 64-bit search function passed to timer
+ * @param lote batch search function passed to timer
+ * @param generator int generator of the keys to search, used if
+ *        generator64 is NULL
+ * @param generator64 64-bit generator of the keys to search
+ * @param order order of the dictionary
+ * @param N size of the dictionary
+ * @param n_times number of times each key is searched on average
+ * @param ptime pointer to the struct time_aa
+ * @return OK
+ *         ERR in case of error
+ */
+static short average_search(pfunc_time_keys timer, pfunc_search64 metodo,
+                            pfunc_search_batch lote, pfunc_key_generator generator,
+                            pfunc_key_generator64 generator64,
+                            int order, long N, long n_times, PTIME_AA ptime)
+{
+  PDICT pdict = NULL;
+  int *tsearch = NULL;
+  long st, n_keys;
+
+  /* Control de errores */
+  assert(timer != NULL);
+  assert(generator != NULL || generator64 != NULL);
+  assert(ptime != NULL);
+  assert(n_times > 0 && N > 0);
+
+  pdict = search_dictionary_of(order, N);
+  if (pdict == NULL)
+    return ERR;
+
   /* Reservamos memoria para la tabla de las n_times * N claves a buscar */
   n_keys = n_times * N;
-  tsearch = (int *)malloc(n_keys * sizeof(tsearch[0]));
+  tsearch = (int *)malloc((size_t)n_keys * sizeof(tsearch[0]));
   if (tsearch == NULL)
   {
     free_dictionary(pdict);
-    free(perm);
     return ERR;
   }
 
   /* Llenamos la tabla anterior con los generadores de claves */
-  generator(tsearch, n_keys, N);
+  st = generate_keys(generator, generator64, tsearch, n_keys, (int)N);
 
   /* Medimos el tiempo que tarda en buscar las claves */
+  if (st == OK)
+    st = timer(pdict, tsearch, n_keys, metodo, lote, ptime);
+
+  free(tsearch);
+  free_dictionary(pdict);
+
+  if (st == ERR)
+    return ERR;
+
+  /* Almacenamos los campos que faltan */
+  ptime->N = N;
+  ptime->n_elems = n_keys;
+
+  return OK;
+}
+
+/**
+ * Searches the n_keys keys of tsearch in the dictionary with the batch
+ * search lote. The ob of every key are taken searching it in a batch of 
+ * its own, since they do not depend on the other keys of the batch; the
+ * time, with all the keys in one batch of the uncounted variant. It is
+ * wall clock time, since the batch may run on the thread pool
+ * @param pdict pointer to the dictionary
+ * @param tsearch keys to search
+ * @param n_keys number of keys
+ * @param metodo unused
+ * @param lote batch search function
+ * @param ptime pointer to the struct time_aa where time and ob are stored
+ * @return OK
+ *         ERR in case of error
+ */
+static short time_batch_keys(PDICT pdict, int *tsearch, long n_keys,
+                             pfunc_search64 metodo, pfunc_search_batch lote,
+                             PTIME_AA ptime)
+{
+  long *pos = NULL, i, min_ob = LONG_MAX, max_ob = 0, ob;
+  long suma_obs = 0;
+  COUNTERS cuentas;
+  PCOUNTERS previas;
+  double begin, end;
+
+  (void)metodo;
+
+  pos = (long *)malloc((size_t)n_keys * sizeof(pos[0]));
+  if (pos == NULL)
+    return ERR;
+
+  /* Primera pasada: ob de cada clave con la variante que cuenta */
+  reset_counters(&cuentas);
   for (i = 0; i < n_keys; i++)
   {
-    begin = clock();
-    if (begin == (clock_t)-1)
-    {
-      free_dictionary(pdict);
-      free(perm);
-      free(tsearch);
-      return ERR;
-    }
-
-    ob = metodo(pdict->table, 0, n_keys, tsearch[i], &pos);
+    previas = set_counters(&cuentas);
+    ob = lote(pdict, &tsearch[i], 1, &pos[i]);
+    set_counters(previas);
     if (ob == ERR)
     {
-      free_dictionary(pdict);
-      free(perm);
-      free(tsearch);
-      return ERR;
-    }
-
-    end = clock();
-    if (end == (clock_t)-1)
-    {
-      free_dictionary(pdict);
-      free(perm);
-      free(tsearch);
+      free(pos);
       return ERR;
     }
 
-    /* Almacenamos las obs */
     suma_obs += ob;
-
-    /* Almacenamos valor mínimo y máximo */
     if (min_ob > ob)
       min_ob = ob;
-
     if (max_ob < ob)
       max_ob = ob;
-
-    /* Almacenamos los tiempos */
-    tiempo = (double)(end - begin) / CLOCKS_PER_SEC * 1e9; /* Multiplicamos por 1e9 para extraer el tiempo en nanosegundos */
-    suma_tiempo += tiempo;
   }
 
-  /* Almacenamos los campos que faltan */
-  ptime->N = N;
-  ptime->n_elems = n_keys;
-  ptime->time = suma_tiempo / (double)n_keys;
+  /* Segunda pasada: tiempo de un solo lote sin contar */
+  begin = wall_time();
+  ob = uncounted_search_batch(lote)(pdict, tsearch, n_keys, pos);
+  end = wall_time();
+
+  free(pos);
+  if (begin == ERR || end == ERR || ob == ERR)
+    return ERR;
+
+  ptime->time = (end - begin) / n_keys; /* en nanosegundos */
   ptime->average_ob = suma_obs / (double)n_keys;
   ptime->min_ob = min_ob;
   ptime->max_ob = max_ob;
+  average_counters(ptime, &cuentas, n_keys);
 
   return OK;
 }
+
+short average_search_time(pfunc_search metodo, pfunc_key_generator generator,
+                          int order,
+                          long N,
+                          long n_times,
+                          PTIME_AA ptime)
+{
+  /* Control de errores */
+  if (wide_search(metodo) == NULL)
+    return ERR;
+
+  return average_search(time_search_keys, wide_search(metodo), NULL, generator, NULL,
+                        order, N, n_times, ptime);
+}
+
+/**
+ * 64-bit version of average_search_time: sizes and ob are long. The keys
+ * of the dictionary are a permutation, so N can be at most INT_MAX
+ * @param metodo 64-bit search function
+ * @param generator generator of the keys to search
+ * @param order SORTED or NOT_SORTED
+ * @param N size of the dictionary
+ * @param n_times number of times each key is searched on average
+ * @param ptime pointer to the struct time_aa
+ * @return OK
+ *         ERR in case of error
+ */
+short average_search_time64(pfunc_search64 metodo, pfunc_key_generator64 generator,
+                            int order, long N, long n_times, PTIME_AA ptime)
+{
+  /* Control de errores */
+  if (metodo == NULL)
+    return ERR;
+
+  return average_search(time_search_keys, metodo, NULL, NULL, generator, order, N, n_times, ptime);
+}
+
+/**
+ * Same as average_search_time64, searching all the keys in one call to a
+ * batch search function
+ * @param metodo batch search function, like search_dictionary_batch
+ * @param generator generator of the keys to search
+ * @param order order of the dictionary
+ * @param N size of the dictionary
+ * @param n_times number of times each key is searched on average
+ * @param ptime pointer to the struct time_aa
+ * @return OK
+ *         ERR in case of error
+ */
+short average_batch_search_time(pfunc_search_batch metodo, pfunc_key_generator64 generator,
+                                int order, long N, long n_times, PTIME_AA ptime)
+{
+  /* Control de errores */
+  if (metodo == NULL)
+    return ERR;
+
+  return average_search(time_batch_keys, NULL, metodo, NULL, generator, order, N, n_times, ptime);
+}
+
+/**
+ * Calls average_search with timer for every size from num_min to num_max
+ * with step incr and saves the resulting table in file
+ * @param timer function that searches the keys and fills the times
+ * @param method 64-bit search function passed to timer
+ * @param batch batch search function passed to timer
+ * @param generator int generator of the keys to search, used if
+ *        generator64 is NULL
+ * @param generator64 64-bit generator of the keys to search
+ * @param order order of the dictionary
+ * @param file name of the output file
+ * @param num_min minimum size of the dictionary
+ * @param num_max maximum size of the dictionary
+ * @param incr increment of the size of the dictionary
+ * @param n_times number of times each key is searched on average
+ * @return OK
+ *         ERR in case of error
+ */
+static short generate_search(pfunc_time_keys timer, pfunc_search64 method,
+                             pfunc_search_batch batch, pfunc_key_generator generator,
+                             pfunc_key_generator64 generator64, int order, char *file,
+                             long num_min, long num_max, long incr, long n_times)
+{
+  TIME_AA *time = NULL;
+  long i, j, n_sizes;
+  short status = ERR;
+
+  /* Control de errores inicial */
+  assert(timer != NULL);
+  assert(generator != NULL || generator64 != NULL);
+  assert(file != NULL);
+  assert(num_min <= num_max);
+  assert(incr > 0);
+
+  n_sizes = ((num_max - num_min) / incr) + 1;
+
+  /* Guardamos memoria para los tiempos de ejecución */
+  time = (PTIME_AA)malloc((size_t)n_sizes * sizeof(time[0]));
+  if (time == NULL)
+    return ERR;
+
+  /* Generamos en este array todos los tiempos medios y los imprimimos */
+  for (i = 0, j = num_min; i < n_sizes && j <= num_max; i++, j += incr)
+  {
+    status = average_search(timer, method, batch, generator, generator64, order, j, n_times,
+                            &time[i]);
+    if (status == ERR)
+    {
+      free(time);
+      return ERR;
+    }
+  }
+
+  status = save_time_table(file, time, n_sizes);
+
+  if (status == ERR)
+  {
+    free(time);
+    return ERR;
+  }
+
+  free(time);
+  return OK;
+}
+
+short generate_search_times(pfunc_search method, pfunc_key_generator generator,
+                            int order, char *file,
+                            long num_min, long num_max,
+                            long incr, long n_times)
+{
+  assert(method != NULL);
+
+  if (wide_search(method) == NULL)
+    return ERR;
+
+  return generate_search(time_search_keys, wide_search(method), NULL, generator, NULL, order,
+                         file, num_min, num_max, incr, n_times);
+}
+
+/**
+ * Same as generate_search_times, searching the keys of each size with
+ * average_batch_search_time
+ * @param method batch search function, like search_dictionary_batch
+ * @param generator generator of the keys to search
+ * @param order order of the dictionary
+ * @param file name of the output file
+ * @param num_min minimum size of the dictionary
+ * @param num_max maximum size of the dictionary
+ * @param incr increment of the size of the dictionary
+ * @param n_times number of times each key is searched on average
+ * @return OK
+ *         ERR in case of error
+ */
+short generate_batch_search_times(pfunc_search_batch method, pfunc_key_generator64 generator,
+                                  int order, char *file, long num_min, long num_max,
+                                  long incr, long n_times)
+{
+  assert(method != NULL);
+
+  return generate_search(time_batch_keys, NULL, method, NULL, generator, order, file,
+                         num_min, num_max, incr, n_times);
+}
+
+/**
+ * Searches the n_times * N keys of generator in a dictionary of size N
+ * with pool_search_batch on pools of 1 to max_threads threads (one per 
+ * online CPU if max_threads < 1), and saves in file a line per number of
+ * threads: threads, wall clock time per key in nanoseconds, keys searched 
+ * per second and speedup over one thread
+ * @param generator generator of the keys to search
+ * @param order order of the dictionary
+ * @param file name of the output file
+ * @param N size of the dictionary
+ * @param n_times number of times each key is searched on average
+ * @param max_threads maximum number of threads
+ * @return OK
+ *         ERR in case of error
+ */
+short generate_scaling_times(pfunc_key_generator64 generator, int order, char *file,
+                             long N, long n_times, int max_threads)
+{
+  PDICT pdict = NULL;
+  PPOOL ppool = NULL;
+  FILE *pf = NULL;
+  int *tsearch = NULL, t;
+  long *pos = NULL, n_keys, st;
+  double begin, end, tiempo, base = 0;
+  short status = OK;
+
+  /* Control de errores */
+  assert(generator != NULL);
+  assert(file != NULL);
+  assert(n_times > 0 && N > 0);
+
+  if (max_threads < 1)
+  {
+    ppool = init_pool(0);
+    if (ppool == NULL)
+      return ERR;
+    max_threads = pool_size(ppool);
+    free_pool(ppool);
+  }
+
+  pdict = search_dictionary_of(order, N);
+  if (pdict == NULL)
+    return ERR;
+
+  n_keys = n_times * N;
+  tsearch = (int *)malloc((size_t)n_keys * sizeof(tsearch[0]));
+  pos = (long *)malloc((size_t)n_keys * sizeof(pos[0]));
+  pf = fopen(file, "w");
+  if (tsearch == NULL || pos == NULL || pf == NULL)
+  {
+    if (pf != NULL)
+      fclose(pf);
+    free(pos);
+    free(tsearch);
+    free_dictionary(pdict);
+    return ERR;
+  }
+
+  generator(tsearch, n_keys, (int)N);
+
+  /* Una pasada previa para que todos partan con la caché caliente */
+  if (simd_search_batch_nc(pdict, tsearch, n_keys, pos) == ERR)
+    status = ERR;
+
+  for (t = 1; t <= max_threads && status == OK; t++)
+  {
+    ppool = init_pool(t);
+    if (ppool == NULL)
+    {
+      status = ERR;
+      break;
+    }
+
+    begin = wall_time();
+    st = pool_search_batch_nc(ppool, pdict, tsearch, n_keys, pos);
+    end = wall_time();
+    free_pool(ppool);
+
+    if (begin == ERR || end == ERR || st == ERR)
+    {
+      status = ERR;
+      break;
+    }
+
+    tiempo = (end - begin) / n_keys; /* en nanosegundos */
+    if (t == 1)
+      base = tiempo;
+
+    if (fprintf(pf, "%d %.2f %.0f %.2f\n", t, tiempo,
+                tiempo > 0 ? 1e9 / tiempo : 0, tiempo > 0 ? base / tiempo : 0) < 0)
+      status = ERR;
+  }
+
+  fclose(pf);
+  free(pos);
+  free(tsearch);
+  free_dictionary(pdict);
+
+  return status;
+}
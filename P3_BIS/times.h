@@ -21,33 +21,54 @@
 
 #include "sorting.h"
 #include "search.h"
+#include "ob.h"
 
 /* type definitions */
 typedef struct time_aa {
-  int N;           /* size of each element */
-  int n_elems;     /* number of elements to average */
+  long N;          /* size of each element */
+  long n_elems;    /* number of elements to average */
   double time;   /* average clock time */
   double average_ob; /* average number of times that the OB is executed */
-  int min_ob;      /* minimum of executions of the OB */
-  int max_ob;      /* maximum of executions of the OB */
+  long min_ob;     /* minimum of executions of the OB */
+  long max_ob;     /* maximum of executions of the OB */
+  double average_cmp;    /* average number of key comparisons */
+  double average_swaps;  /* average number of swaps */
+  double average_moves;  /* average number of elements moved */
+  double average_allocs; /* average number of allocations */
+  double average_bytes;  /* average number of bytes copied */
 } TIME_AA, *PTIME_AA;
 
 
 /* Functions */
-short average_sorting_time(pfunc_sort method, int n_perms,int N, PTIME_AA ptime);
-short generate_sorting_times(pfunc_sort method, char* file, int num_min, int num_max, int incr, int n_perms);
-short save_time_table(char* file, PTIME_AA time, int n_times);
+short average_sorting_time(pfunc_sort method, long n_perms,long N, PTIME_AA ptime);
+short average_sorting_time64(pfunc_sort64 method, long n_perms, long N, PTIME_AA ptime);
+short generate_sorting_times(pfunc_sort method, char* file, long num_min, long num_max, long incr, long n_perms);
+short average_sorting_time_double(pfunc_sort_double method, long n_perms, long N, PTIME_AA ptime);
+short generate_sorting_times_double(pfunc_sort_double method, char* file, long num_min, long num_max, long incr, long n_perms);
+short save_time_table(char* file, PTIME_AA time, long n_times);
+short set_input_shape(int shape);
+short average_batch_sorting_time(pfunc_sort method, long n_perms, long N, PTIME_AA ptime);
+short generate_batch_sorting_times(pfunc_sort method, char* file, long num_min, long num_max, long incr, long n_perms);
 
 short generate_search_times(pfunc_search method, pfunc_key_generator generator, 
                                 int order, char* file, 
-                                int num_min, int num_max, 
-                                int incr, int n_times);
+                                long num_min, long num_max, 
+                                long incr, long n_times);
 
 short average_search_time(pfunc_search metodo, pfunc_key_generator generator,
                               int order,
-                              int N, 
-                              int n_times,
+                              long N, 
+                              long n_times,
                               PTIME_AA ptime);
+short average_search_time64(pfunc_search64 metodo, pfunc_key_generator64 generator,
+                            int order, long N, long n_times, PTIME_AA ptime);
+short average_batch_search_time(pfunc_search_batch method, pfunc_key_generator64 generator,
+                                int order, long N, long n_times, PTIME_AA ptime);
+short generate_batch_search_times(pfunc_search_batch method, pfunc_key_generator64 generator,
+                                  int order, char *file, long num_min, long num_max,
+                                  long incr, long n_times);
+short generate_scaling_times(pfunc_key_generator64 generator, int order, char *file,
+                             long N, long n_times, int max_threads);
 
 
 #endif